@@ -0,0 +1,140 @@
+#include "Bitboard.h"
+#include "Prng.h"
+
+Bitboard PawnAttackTable[3][64];
+Bitboard KnightAttackTable[64];
+Bitboard KingAttackTable[64];
+Bitboard BetweenTable[64][64];
+Bitboard LineTable[64][64];
+
+Magic RookMagics[64];
+Magic BishopMagics[64];
+bool UsePext = false;
+
+namespace {
+Bitboard RookTable[0x19000];
+Bitboard BishopTable[0x1480];
+
+const int kRookDirs[4][2] = { {1,0}, {-1,0}, {0,1}, {0,-1} };
+const int kBishopDirs[4][2] = { {1,1}, {-1,1}, {1,-1}, {-1,-1} };
+
+// Ray attacks that stop at (and include) the first occupied square. Only
+// used to fill the lookup tables.
+Bitboard SlidingAttacks(Square s, Bitboard occupied, const int (*dirs)[2]) {
+    Bitboard attacks = 0;
+    for (int d = 0; d < 4; ++d) {
+        int x = FileOf(s) + dirs[d][0];
+        int y = RankOf(s) + dirs[d][1];
+        while (IsInsideBoard(x, y)) {
+            Bitboard b = SquareBB(MakeSquare(x, y));
+            attacks |= b;
+            if (occupied & b) break;
+            x += dirs[d][0];
+            y += dirs[d][1];
+        }
+    }
+    return attacks;
+}
+
+void InitSliderTable(Magic* magics, Bitboard* table, const int (*dirs)[2]) {
+    Bitboard occupancy[4096];
+    Bitboard reference[4096];
+    int epoch[4096] = {};
+    int attempt = 0;
+    int size = 0;
+    Prng prng(728);
+
+    for (Square s = 0; s < 64; ++s) {
+        // Board edges are not part of the relevant occupancy unless the
+        // slider stands on them
+        Bitboard edges = ((Rank1BB | Rank8BB) & ~RankBB(RankOf(s)))
+                       | ((FileABB | FileHBB) & ~FileBB(FileOf(s)));
+
+        Magic& m = magics[s];
+        m.mask = SlidingAttacks(s, 0, dirs) & ~edges;
+        m.shift = 64 - PopCount(m.mask);
+        m.attacks = (s == 0) ? table : magics[s - 1].attacks + size;
+
+        // Enumerate every subset of the mask (Carry-Rippler)
+        size = 0;
+        Bitboard b = 0;
+        do {
+            occupancy[size] = b;
+            reference[size] = SlidingAttacks(s, b, dirs);
+#if defined(HAS_PEXT)
+            if (UsePext) m.attacks[Pext(b, m.mask)] = reference[size];
+#endif
+            ++size;
+            b = (b - m.mask) & m.mask;
+        } while (b);
+
+        if (UsePext) continue;
+
+        // Try random sparse candidates until one maps every subset either
+        // to an unused slot or to a slot holding the same attack set
+        for (int i = 0; i < size; ) {
+            for (m.magic = 0; PopCount((m.magic * m.mask) >> 56) < 6; ) {
+                m.magic = prng.Sparse();
+            }
+
+            for (++attempt, i = 0; i < size; ++i) {
+                unsigned idx = m.Index(occupancy[i]);
+                if (epoch[idx] < attempt) {
+                    epoch[idx] = attempt;
+                    m.attacks[idx] = reference[i];
+                } else if (m.attacks[idx] != reference[i]) {
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void InitAttackTables() {
+#if defined(HAS_PEXT)
+    // Called during static initialization, possibly before libgcc has
+    // identified the CPU
+    __builtin_cpu_init();
+    UsePext = __builtin_cpu_supports("bmi2");
+#endif
+
+    for (Square s = 0; s < 64; ++s) {
+        Bitboard b = SquareBB(s);
+        PawnAttackTable[int(PieceColor::WHITE)][s] = PawnAttacks(b, PieceColor::WHITE);
+        PawnAttackTable[int(PieceColor::BLACK)][s] = PawnAttacks(b, PieceColor::BLACK);
+
+        Bitboard east1 = ShiftEast(b), west1 = ShiftWest(b);
+        Bitboard east2 = ShiftEast(east1), west2 = ShiftWest(west1);
+        Bitboard horizontal1 = east1 | west1;
+        Bitboard horizontal2 = east2 | west2;
+        KnightAttackTable[s] = (horizontal1 << 16) | (horizontal1 >> 16)
+                             | (horizontal2 << 8) | (horizontal2 >> 8);
+
+        Bitboard row = b | east1 | west1;
+        KingAttackTable[s] = (row | ShiftNorth(row) | ShiftSouth(row)) & ~b;
+    }
+
+    InitSliderTable(RookMagics, RookTable, kRookDirs);
+    InitSliderTable(BishopMagics, BishopTable, kBishopDirs);
+
+    for (Square a = 0; a < 64; ++a) {
+        for (Square b = 0; b < 64; ++b) {
+            Bitboard ends = SquareBB(a) | SquareBB(b);
+            if (a == b) continue;
+            if (RookAttacks(a, 0) & SquareBB(b)) {
+                LineTable[a][b] = (RookAttacks(a, 0) & RookAttacks(b, 0)) | ends;
+                BetweenTable[a][b] = RookAttacks(a, SquareBB(b)) & RookAttacks(b, SquareBB(a));
+            } else if (BishopAttacks(a, 0) & SquareBB(b)) {
+                LineTable[a][b] = (BishopAttacks(a, 0) & BishopAttacks(b, 0)) | ends;
+                BetweenTable[a][b] = BishopAttacks(a, SquareBB(b)) & BishopAttacks(b, SquareBB(a));
+            }
+        }
+    }
+}
+
+// Tables are filled during static initialisation of this file, before any
+// position can be built.
+struct AttackTablesInit {
+    AttackTablesInit() { InitAttackTables(); }
+} attackTablesInit;
+}
@@ -0,0 +1,104 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+#include "Types.h"
+
+// PEXT is emitted with inline assembly so the build stays portable; it is
+// only executed after the CPU has reported BMI2 at startup. Define NO_PEXT
+// on CPUs where PEXT is microcoded (AMD before Zen 3).
+#if defined(__x86_64__) && !defined(NO_PEXT)
+#define HAS_PEXT 1
+#endif
+
+// One bit per square, bit 0 = a1, bit 63 = h8.
+using Bitboard = uint64_t;
+
+constexpr Bitboard FileABB = 0x0101010101010101ULL;
+constexpr Bitboard FileHBB = FileABB << 7;
+constexpr Bitboard Rank1BB = 0xFFULL;
+constexpr Bitboard Rank8BB = Rank1BB << 56;
+
+inline Bitboard SquareBB(Square s) { return 1ULL << s; }
+inline Bitboard FileBB(int file) { return FileABB << file; }
+inline Bitboard RankBB(int rank) { return Rank1BB << (8 * rank); }
+
+inline int PopCount(Bitboard b) { return __builtin_popcountll(b); }
+inline Square Lsb(Bitboard b) { return __builtin_ctzll(b); }
+inline Square PopLsb(Bitboard& b) {
+    Square s = Lsb(b);
+    b &= b - 1;
+    return s;
+}
+inline bool MoreThanOne(Bitboard b) { return b & (b - 1); }
+
+inline Bitboard ShiftNorth(Bitboard b) { return b << 8; }
+inline Bitboard ShiftSouth(Bitboard b) { return b >> 8; }
+inline Bitboard ShiftEast(Bitboard b) { return (b & ~FileHBB) << 1; }
+inline Bitboard ShiftWest(Bitboard b) { return (b & ~FileABB) >> 1; }
+
+inline Bitboard PawnAttacks(Bitboard pawns, PieceColor color) {
+    Bitboard forward = (color == PieceColor::WHITE) ? ShiftNorth(pawns) : ShiftSouth(pawns);
+    return ShiftEast(forward) | ShiftWest(forward);
+}
+
+// Attack tables, built once at startup (see Bitboard.cpp).
+extern Bitboard PawnAttackTable[3][64];
+extern Bitboard KnightAttackTable[64];
+extern Bitboard KingAttackTable[64];
+// Squares strictly between two squares on a shared rank, file or diagonal,
+// and the whole line through them (both empty if they are not aligned)
+extern Bitboard BetweenTable[64][64];
+extern Bitboard LineTable[64][64];
+
+// Slider attacks for one square are stored densely in a shared table and
+// indexed by the relevant occupancy bits: with PEXT when the build and the
+// CPU support it, otherwise with a magic multiply and shift.
+extern bool UsePext;
+
+#if defined(HAS_PEXT)
+inline Bitboard Pext(Bitboard source, Bitboard mask) {
+    Bitboard result;
+    asm("pextq %2, %1, %0" : "=r"(result) : "r"(source), "r"(mask));
+    return result;
+}
+#endif
+
+struct Magic {
+    Bitboard mask;
+    Bitboard magic;
+    Bitboard* attacks;
+    unsigned shift;
+
+    unsigned Index(Bitboard occupied) const {
+#if defined(HAS_PEXT)
+        if (UsePext) return unsigned(Pext(occupied, mask));
+#endif
+        return unsigned(((occupied & mask) * magic) >> shift);
+    }
+};
+
+extern Magic RookMagics[64];
+extern Magic BishopMagics[64];
+
+inline Bitboard PawnAttacks(Square s, PieceColor color) { return PawnAttackTable[int(color)][s]; }
+inline Bitboard KnightAttacks(Square s) { return KnightAttackTable[s]; }
+inline Bitboard KingAttacks(Square s) { return KingAttackTable[s]; }
+inline Bitboard BetweenBB(Square a, Square b) { return BetweenTable[a][b]; }
+inline Bitboard LineBB(Square a, Square b) { return LineTable[a][b]; }
+
+inline Bitboard RookAttacks(Square s, Bitboard occupied) {
+    const Magic& m = RookMagics[s];
+    return m.attacks[m.Index(occupied)];
+}
+
+inline Bitboard BishopAttacks(Square s, Bitboard occupied) {
+    const Magic& m = BishopMagics[s];
+    return m.attacks[m.Index(occupied)];
+}
+
+inline Bitboard QueenAttacks(Square s, Bitboard occupied) {
+    return RookAttacks(s, occupied) | BishopAttacks(s, occupied);
+}
+
+#endif // BITBOARD_H
@@ -1,29 +1,77 @@
 #include "Board.h"
 #include "PieceFactory.h"
-#include "Pawn.h"
-#include "King.h"
-#include "Rook.h"
-#include "Queen.h"
-#include "Knight.h"
-#include "Bishop.h"
+#include "MoveGen.h"
 #include <wx/dcbuffer.h>
 #include <wx/msgdlg.h>
 #include <algorithm>
 #include <random>
-#include <map>
-#include <climits>
-#include <cmath>
-#include <unordered_set>
-#include <chrono>
+
+namespace {
+enum {
+    ID_SEARCH_DONE = wxID_HIGHEST + 1,
+    ID_SEARCH_INFO
+};
+}
 
 wxBEGIN_EVENT_TABLE(Board, wxPanel)
     EVT_PAINT(Board::OnPaint)
     EVT_LEFT_DOWN(Board::OnLeftDown)
+    EVT_THREAD(ID_SEARCH_DONE, Board::OnSearchFinished)
+    EVT_THREAD(ID_SEARCH_INFO, Board::OnSearchInfo)
 wxEND_EVENT_TABLE()
 
+namespace {
+// The GUI draws rank 8 at the top (y == 0); the engine numbers squares from a1.
+Square ToSquare(int x, int y) { return MakeSquare(x, 7 - y); }
+Square ToSquare(wxPoint p) { return ToSquare(p.x, p.y); }
+wxPoint ToPoint(Square s) {
+    if (s == NO_SQUARE) return wxPoint(-1, -1);
+    return wxPoint(FileOf(s), 7 - RankOf(s));
+}
+
+wxString FormatSearchInfo(const SearchInfo& info) {
+    wxString score;
+    // Mate scores count plies; shown as full moves
+    if (info.score >= MATE_IN_MAX_PLY) score = wxString::Format("mate in %d", (MATE_SCORE - info.score + 1) / 2);
+    else if (info.score <= -MATE_IN_MAX_PLY) score = wxString::Format("mated in %d", (MATE_SCORE + info.score) / 2);
+    else score = wxString::Format("%+.2f", info.score / 100.0);
+
+    wxString pv;
+    for (Move move : info.pv) pv += " " + wxString(move.ToString());
+
+    // Per thread in thousands of nodes, e.g. "t0:12k t1:11k"
+    wxString threads;
+    for (size_t i = 0; i < info.threadNodes.size(); ++i) {
+        threads += wxString::Format(i ? " t%zu:%lluk" : "t%zu:%lluk", i,
+                                    (unsigned long long)(info.threadNodes[i] / 1000));
+    }
+
+    int evalHitRate = info.evalProbes ? int(info.evalHits * 100 / info.evalProbes) : 0;
+
+    return wxString::Format("Depth %d  Score %s  Nodes %llu (%s)  Eval cache %d%%  %d ms  PV%s",
+                            info.depth, score, (unsigned long long)info.nodes,
+                            threads, evalHitRate, info.elapsedMs, pv);
+}
+}
+
 Board::Board(wxWindow* parent) : wxPanel(parent) {
     SetBackgroundStyle(wxBG_STYLE_PAINT);
     InitNewGame();
+
+    engine.SetThreads(int(std::max(1u, std::thread::hardware_concurrency())));
+    // Optional: without a network file next to the program the classical
+    // evaluation is used
+    engine.LoadNetwork("network.nnue");
+
+    // Progress is reported from the search thread, so it is only ever
+    // queued to the UI thread, never shown from here
+    engine.SetInfoCallback([this](const SearchInfo& info) {
+        wxThreadEvent* event = new wxThreadEvent(wxEVT_THREAD, ID_SEARCH_INFO);
+        event->SetString(FormatSearchInfo(info));
+        event->SetExtraLong(runningGeneration);
+        wxQueueEvent(this, event);
+    });
+    searchThread = std::thread(&Board::SearchThreadLoop, this);
     
     wxTheApp->CallAfter([this]() {
         if (IsComputerTurn()) {
@@ -34,123 +82,94 @@ Board::Board(wxWindow* parent) : wxPanel(parent) {
 
 bool Board::IsEmpty(int x, int y) const {
     if (x < 0 || x >= 8 || y < 0 || y >= 8) return false;
-    return !board[x][y];
+    return position.IsEmpty(ToSquare(x, y));
 }
 
 bool Board::IsEnemy(int x, int y, PieceColor color) const {
     if (x < 0 || x >= 8 || y < 0 || y >= 8) return false;
-    return board[x][y] && board[x][y]->GetColor() != color;
+    return position.IsEnemy(ToSquare(x, y), color);
 }
 
 bool Board::IsValidMove(int fromX, int fromY, int toX, int toY) const {
-    if (!board[fromX][fromY]) return false;
-    if (board[toX][toY] && board[toX][toY]->GetColor() == board[fromX][fromY]->GetColor()) {
+    Square from = ToSquare(fromX, fromY);
+    Square to = ToSquare(toX, toY);
+    if (position.IsEmpty(from)) return false;
+    if (!position.IsEmpty(to) && position.GetPieceColor(to) == position.GetPieceColor(from)) {
         return false;
     }
     return true;
 }
 
-Piece* Board::GetPieceAt(wxPoint p) const {
+const Piece* Board::GetPieceAt(wxPoint p) const {
     if (p.x < 0 || p.x >= 8 || p.y < 0 || p.y >= 8) return nullptr;
-    return board[p.x][p.y].get();
+    return board[p.x][p.y];
+}
+
+std::vector<wxPoint> Board::GetLegalMoves(wxPoint from) const {
+    std::vector<wxPoint> targets;
+    if (!IsInsideBoard(from)) return targets;
+    MoveList moves;
+    GenerateLegalMovesFrom(position, ToSquare(from), moves);
+    for (Move move : moves) {
+        // One square per promotion, not one per piece
+        if (move.IsPromotion() && move.PromotionType() != PieceType::QUEEN) continue;
+        targets.push_back(ToPoint(move.To()));
+    }
+    return targets;
 }
 
 bool Board::IsRook(int x, int y, PieceColor color) const {
     if (x < 0 || x >= 8 || y < 0 || y >= 8) return false;
-    auto piece = board[x][y].get();
-    return piece && piece->GetType() == PieceType::ROOK && piece->GetColor() == color;
+    Square s = ToSquare(x, y);
+    return position.GetPieceType(s) == PieceType::ROOK && position.GetPieceColor(s) == color;
+}
+
+wxPoint Board::GetEnPassantTarget() const {
+    return ToPoint(position.GetEnPassantTarget());
+}
+
+void Board::SetEnPassantTarget(wxPoint target) {
+    position.SetEnPassantTarget(target.x == -1 ? NO_SQUARE : ToSquare(target));
 }
 
 void Board::SetKingMoved(PieceColor color) {
-    if (color == PieceColor::WHITE) whiteKingMoved = true;
-    else blackKingMoved = true;
+    position.SetKingMoved(color);
 }
 
 void Board::SetRookMoved(int x, int y) {
-    if (y == 0) {
-        if (x == 0) blackRookQMoved = true;
-        else if (x == 7) blackRookKMoved = true;
-    } else if (y == 7) {
-        if (x == 0) whiteRookQMoved = true;
-        else if (x == 7) whiteRookKMoved = true;
-    }
+    position.SetRookMoved(ToSquare(x, y));
 }
 
 bool Board::CanCastleKingside(PieceColor color) const {
-    if (color == PieceColor::WHITE) 
-        return !whiteKingMoved && !whiteRookKMoved;
-    else 
-        return !blackKingMoved && !blackRookKMoved;
+    return position.CanCastleKingside(color);
 }
 
 bool Board::CanCastleQueenside(PieceColor color) const {
-    if (color == PieceColor::WHITE) 
-        return !whiteKingMoved && !whiteRookQMoved;
-    else 
-        return !blackKingMoved && !blackRookQMoved;
+    return position.CanCastleQueenside(color);
 }
 
 bool Board::IsSquareUnderAttack(wxPoint square, PieceColor attackerColor) const {
-    for (int x = 0; x < 8; x++) {
-        for (int y = 0; y < 8; y++) {
-            Piece* piece = board[x][y].get();
-            if (piece && piece->GetColor() == attackerColor) {
-                PieceType type = piece->GetType();
-                
-                if (type == PieceType::KING) {
-                    if (abs(square.x - x) <= 1 && abs(square.y - y) <= 1) {
-                        return true;
-                    }
-                } 
-                else if (type == PieceType::PAWN) {
-                    int direction = (attackerColor == PieceColor::WHITE) ? -1 : 1;
-                    if (y + direction == square.y && 
-                        (x - 1 == square.x || x + 1 == square.x)) {
-                        return true;
-                    }
-                } 
-                else {
-                    auto moves = piece->GetPossibleMoves(*this, wxPoint(x, y));
-                    if (std::find(moves.begin(), moves.end(), square) != moves.end()) {
-                        return true;
-                    }
-                }
-            }
-        }
-    }
-    return false;
+    return position.IsSquareUnderAttack(ToSquare(square), attackerColor);
 }
 
 bool Board::IsKingInCheck(PieceColor color) const {
-    wxPoint kingPos = GetKingPosition(color);
-    PieceColor attacker = (color == PieceColor::WHITE) ? PieceColor::BLACK : PieceColor::WHITE;
-    return IsSquareUnderAttack(kingPos, attacker);
+    return position.IsKingInCheck(color);
 }
 
 wxPoint Board::GetKingPosition(PieceColor color) const {
-    return (color == PieceColor::WHITE) ? whiteKingPos : blackKingPos;
+    return ToPoint(position.GetKingSquare(color));
 }
 
 std::vector<wxPoint> Board::GetCheckingPieces(PieceColor color) const {
     std::vector<wxPoint> checkers;
-    wxPoint kingPos = GetKingPosition(color);
-    PieceColor attackerColor = (color == PieceColor::WHITE) ? PieceColor::BLACK : PieceColor::WHITE;
-
-    for (int x = 0; x < 8; x++) {
-        for (int y = 0; y < 8; y++) {
-            Piece* piece = board[x][y].get();
-            if (piece && piece->GetColor() == attackerColor) {
-                auto moves = piece->GetPossibleMoves(*this, wxPoint(x, y));
-                if (std::find(moves.begin(), moves.end(), kingPos) != moves.end()) {
-                    checkers.push_back(wxPoint(x, y));
-                }
-            }
-        }
+    for (Square s : position.GetCheckingPieces(color)) {
+        checkers.push_back(ToPoint(s));
     }
     return checkers;
 }
 
 void Board::HighlightChecks(wxAutoBufferedPaintDC& dc) const {
+    PieceColor currentTurn = GetCurrentTurn();
     if (IsKingInCheck(currentTurn)) {
         wxPoint kingPos = GetKingPosition(currentTurn);
         wxRect kingRect(kingPos.x * tileSize.x, kingPos.y * tileSize.y, 
@@ -170,253 +189,98 @@ void Board::HighlightChecks(wxAutoBufferedPaintDC& dc) const {
 }
 
 bool Board::IsCheckmate(PieceColor color) {
-    if (!IsKingInCheck(color)) return false;
-    return !HasLegalMoves(color);
+    return color == GetCurrentTurn() && position.IsCheckmate();
 }
 
 bool Board::IsStalemate(PieceColor color) {
-    if (IsKingInCheck(color)) return false;
-    return !HasLegalMoves(color);
+    return color == GetCurrentTurn() && position.IsStalemate();
 }
 
 bool Board::HasLegalMoves(PieceColor color) {
-    for (int x = 0; x < 8; x++) {
-        for (int y = 0; y < 8; y++) {
-            if (board[x][y] && board[x][y]->GetColor() == color) {
-                auto moves = board[x][y]->GetPossibleMoves(*this, wxPoint(x, y));
-                for (const auto& move : moves) {
-                    if (IsMoveLegal(wxPoint(x, y), move)) {
-                        return true;
-                    }
-                }
-            }
-        }
-    }
-    return false;
+    return color == GetCurrentTurn() && position.HasLegalMoves();
 }
 
 bool Board::IsMoveLegal(wxPoint from, wxPoint to) {
-    if (!board[from.x][from.y]) return false;
-    
-    // Early exit for invalid moves
-    if (board[to.x][to.y] && 
-        board[to.x][to.y]->GetColor() == board[from.x][from.y]->GetColor()) {
-        return false;
-    }
-    
-    PieceType movedType = board[from.x][from.y]->GetType();
-    PieceColor movedColor = board[from.x][from.y]->GetColor();
-    bool isEnPassant = (movedType == PieceType::PAWN && to == enPassantTarget);
-    bool isCastling = (movedType == PieceType::KING && abs(to.x - from.x) == 2);
-
-    std::unique_ptr<Piece> backup[3];
-    wxPoint originalWhiteKingPos = whiteKingPos;
-    wxPoint originalBlackKingPos = blackKingPos;
-    
-    backup[0] = std::move(board[from.x][from.y]);
-    backup[1] = std::move(board[to.x][to.y]);
-    
-    if (isEnPassant) {
-        int captureY = (movedColor == PieceColor::WHITE) ? to.y + 1 : to.y - 1;
-        backup[2] = std::move(board[to.x][captureY]);
-        board[to.x][captureY].reset();
-    } else if (isCastling) {
-        if (to.x > from.x) {
-            backup[2] = std::move(board[7][from.y]);
-            board[5][from.y] = std::move(backup[2]);
-        } else {
-            backup[2] = std::move(board[0][from.y]);
-            board[3][from.y] = std::move(backup[2]);
-        }
-    }
+    return !FindLegalMove(from, to).IsNone();
+}
 
-    board[to.x][to.y] = std::move(backup[0]);
-    
-    if (movedType == PieceType::KING) {
-        if (movedColor == PieceColor::WHITE) {
-            whiteKingPos = to;
-        } else {
-            blackKingPos = to;
-        }
-    }
-    
-    bool inCheck = IsKingInCheck(movedColor);
-    
-    board[from.x][from.y] = std::move(board[to.x][to.y]);
-    board[to.x][to.y] = std::move(backup[1]);
-    
-    if (movedType == PieceType::KING) {
-        if (movedColor == PieceColor::WHITE) {
-            whiteKingPos = originalWhiteKingPos;
-        } else {
-            blackKingPos = originalBlackKingPos;
-        }
+Move Board::FindLegalMove(wxPoint from, wxPoint to) {
+    if (!IsInsideBoard(from)) return Move::None();
+    MoveList moves;
+    GenerateLegalMovesFrom(position, ToSquare(from), moves);
+    for (Move move : moves) {
+        if (move.To() != ToSquare(to)) continue;
+        // Pawns reaching the last rank always become queens here
+        if (move.IsPromotion() && move.PromotionType() != PieceType::QUEEN) continue;
+        return move;
     }
-    
-    if (isEnPassant) {
-        int captureY = (movedColor == PieceColor::WHITE) ? to.y + 1 : to.y - 1;
-        board[to.x][captureY] = std::move(backup[2]);
-    } else if (isCastling) {
-        if (to.x > from.x) {
-            board[7][from.y] = std::move(board[5][from.y]);
-            board[5][from.y].reset();
-        } else {
-            board[0][from.y] = std::move(board[3][from.y]);
-            board[3][from.y].reset();
-        }
-    }
-    
-    return !inCheck;
+    return Move::None();
 }
 
-void Board::SaveState() {
-    MoveState state;
-    
+void Board::UpdatePiecesFromPosition() {
     for (int x = 0; x < 8; ++x) {
         for (int y = 0; y < 8; ++y) {
-            if (board[x][y]) {
-                state.board[x][y] = PieceFactory::CreatePiece(
-                    board[x][y]->GetType(), 
-                    board[x][y]->GetColor()
-                );
-            }
+            Square s = ToSquare(x, y);
+            board[x][y] = PieceFactory::GetPiece(position.GetPieceType(s), position.GetPieceColor(s));
         }
     }
-    
-    state.selectedPiece = selectedPiece;
-    state.currentTurn = currentTurn;
-    state.enPassantTarget = enPassantTarget;
-    state.whiteKingPos = whiteKingPos;
-    state.blackKingPos = blackKingPos;
-    state.whiteKingMoved = whiteKingMoved;
-    state.blackKingMoved = blackKingMoved;
-    state.whiteRookKMoved = whiteRookKMoved;
-    state.whiteRookQMoved = whiteRookQMoved;
-    state.blackRookKMoved = blackRookKMoved;
-    state.blackRookQMoved = blackRookQMoved;
-    state.promotionSquare = promotionSquare;
-    
-    moveHistory.push(std::move(state));
 }
 
-void Board::RestoreState(const MoveState& state) {
-    for (int x = 0; x < 8; ++x) {
-        for (int y = 0; y < 8; ++y) {
-            if (state.board[x][y]) {
-                board[x][y] = PieceFactory::CreatePiece(
-                    state.board[x][y]->GetType(), 
-                    state.board[x][y]->GetColor()
-                );
-            } else {
-                board[x][y].reset();
-            }
-        }
+PieceColor Board::SideToMoveAtPly(size_t ply) const {
+    PieceColor first = checkpoints.front().GetSideToMove();
+    return (ply % 2 == 0) ? first : Opponent(first);
+}
+
+void Board::GoToPly(size_t ply) {
+    // Restart from a checkpoint when that is closer than walking from here
+    size_t checkpoint = std::min(ply / CHECKPOINT_INTERVAL, checkpoints.size() - 1);
+    size_t fromCheckpoint = ply - checkpoint * CHECKPOINT_INTERVAL;
+    size_t distance = (ply > historyPly) ? ply - historyPly : historyPly - ply;
+    if (fromCheckpoint < distance) {
+        position = checkpoints[checkpoint];
+        historyPly = checkpoint * CHECKPOINT_INTERVAL;
     }
-    
-    selectedPiece = state.selectedPiece;
-    currentTurn = state.currentTurn;
-    enPassantTarget = state.enPassantTarget;
-    whiteKingPos = state.whiteKingPos;
-    blackKingPos = state.blackKingPos;
-    whiteKingMoved = state.whiteKingMoved;
-    blackKingMoved = state.blackKingMoved;
-    whiteRookKMoved = state.whiteRookKMoved;
-    whiteRookQMoved = state.whiteRookQMoved;
-    blackRookKMoved = state.blackRookKMoved;
-    blackRookQMoved = state.blackRookQMoved;
-    promotionSquare = state.promotionSquare;
-    
+
+    while (historyPly > ply) {
+        --historyPly;
+        position.UnmakeMove(history[historyPly].move, history[historyPly].undo);
+    }
+    while (historyPly < ply) {
+        position.MakeMove(history[historyPly].move, history[historyPly].undo);
+        ++historyPly;
+    }
+
+    UpdatePiecesFromPosition();
+    selectedPiece = wxPoint(-1, -1);
+    promotionSquare = wxPoint(-1, -1);
     possibleMoves.clear();
     gameOver = false;
     gameResult = "";
 }
 
-void Board::GetCurrentState(MoveState& state) const {
-    for (int x = 0; x < 8; ++x) {
-        for (int y = 0; y < 8; ++y) {
-            if (board[x][y]) {
-                state.board[x][y] = PieceFactory::CreatePiece(
-                    board[x][y]->GetType(), 
-                    board[x][y]->GetColor()
-                );
-            } else {
-                state.board[x][y].reset();
-            }
-        }
-    }
-    
-    state.selectedPiece = selectedPiece;
-    state.currentTurn = currentTurn;
-    state.enPassantTarget = enPassantTarget;
-    state.whiteKingPos = whiteKingPos;
-    state.blackKingPos = blackKingPos;
-    state.whiteKingMoved = whiteKingMoved;
-    state.blackKingMoved = blackKingMoved;
-    state.whiteRookKMoved = whiteRookKMoved;
-    state.whiteRookQMoved = whiteRookQMoved;
-    state.blackRookKMoved = blackRookKMoved;
-    state.blackRookQMoved = blackRookQMoved;
-    state.promotionSquare = promotionSquare;
-}
+void Board::DoMove(Move move) {
+    // A new move discards the undone ones
+    history.resize(historyPly);
+    checkpoints.resize(historyPly / CHECKPOINT_INTERVAL + 1);
 
-void Board::DoMove(wxPoint from, wxPoint to) {
-    PieceType movedType = board[from.x][from.y]->GetType();
-    PieceColor movedColor = board[from.x][from.y]->GetColor();
-    
-    if (movedType == PieceType::PAWN && to == enPassantTarget) {
-        int captureY = (movedColor == PieceColor::WHITE) ? to.y + 1 : to.y - 1;
-        board[to.x][captureY].reset();
-    }
-    
-    if (movedType == PieceType::KING) {
-        int deltaX = to.x - from.x;
-        
-        if (deltaX == 2) {
-            board[5][to.y] = std::move(board[7][to.y]);
-            board[7][to.y].reset();
-            SetRookMoved(7, to.y);
-        }
-        else if (deltaX == -2) {
-            board[3][to.y] = std::move(board[0][to.y]);
-            board[0][to.y].reset();
-            SetRookMoved(0, to.y);
-        }
-        SetKingMoved(movedColor);
-        
-        if (movedColor == PieceColor::WHITE) {
-            whiteKingPos = to;
-        } else {
-            blackKingPos = to;
-        }
-    }
-    
-    if (movedType == PieceType::ROOK) {
-        SetRookMoved(from.x, from.y);
-    }
-    
-    if (movedType == PieceType::PAWN && abs(to.y - from.y) == 2) {
-        int epY = (from.y + to.y) / 2;
-        enPassantTarget = wxPoint(to.x, epY);
-    } else {
-        enPassantTarget = wxPoint(-1, -1);
+    UndoInfo undo;
+    position.MakeMove(move, undo);
+    history.push_back({ move, undo });
+    if (++historyPly % CHECKPOINT_INTERVAL == 0) {
+        checkpoints.push_back(position);
     }
-    
-    board[to.x][to.y] = std::move(board[from.x][from.y]);
+    UpdatePiecesFromPosition();
     
     // Sprawdź promocję pionka
-    if (movedType == PieceType::PAWN && (to.y == 0 || to.y == 7)) {
-        promotionSquare = to;
-        HandlePawnPromotion(to);
+    if (move.IsPromotion()) {
+        promotionSquare = ToPoint(move.To());
+        HandlePawnPromotion(promotionSquare);
     }
-    
-    currentTurn = (currentTurn == PieceColor::WHITE) ? PieceColor::BLACK : PieceColor::WHITE;
 }
 
 void Board::PromotePawn(wxPoint pos, PieceType promotionType) {
-    if (board[pos.x][pos.y] && board[pos.x][pos.y]->GetType() == PieceType::PAWN) {
-        PieceColor color = board[pos.x][pos.y]->GetColor();
-        board[pos.x][pos.y] = PieceFactory::CreatePiece(promotionType, color);
-    }
+    position.PromotePawn(ToSquare(pos), promotionType);
+    UpdatePiecesFromPosition();
     promotionSquare = wxPoint(-1, -1);
 }
 
@@ -432,411 +296,87 @@ void Board::HandlePawnPromotion(wxPoint pos) {
     }
 }
 
-int Board::EvaluateMaterial() const {
-    int score = 0;
-    std::map<PieceType, int> pieceValues = {
-        {PieceType::PAWN, 100},
-        {PieceType::KNIGHT, 320},
-        {PieceType::BISHOP, 330},
-        {PieceType::ROOK, 500},
-        {PieceType::QUEEN, 900},
-        {PieceType::KING, 20000}
-    };
-
-    for (int x = 0; x < 8; x++) {
-        for (int y = 0; y < 8; y++) {
-            if (board[x][y]) {
-                Piece* piece = board[x][y].get();
-                int value = pieceValues[piece->GetType()];
-                if (piece->GetColor() == playerColor) {
-                    score += value;
-                } else {
-                    score -= value;
-                }
-            }
-        }
+Board::~Board() {
+    CancelSearch();
+    {
+        std::lock_guard<std::mutex> lock(searchMutex);
+        quitSearchThread = true;
     }
-    return score;
+    searchCondition.notify_all();
+    searchThread.join();
 }
 
-int Board::EvaluateMobility(PieceColor color) const {
-    int mobility = 0;
-    for (int x = 0; x < 8; x++) {
-        for (int y = 0; y < 8; y++) {
-            if (board[x][y] && board[x][y]->GetColor() == color) {
-                auto moves = board[x][y]->GetPossibleMoves(*this, wxPoint(x, y));
-                mobility += moves.size();
-            }
-        }
-    }
-    return mobility;
-}
+void Board::SearchThreadLoop() {
+    std::unique_lock<std::mutex> lock(searchMutex);
+    while (true) {
+        searchCondition.wait(lock, [this] { return searchRequested || quitSearchThread; });
+        if (quitSearchThread) return;
 
-// Board.cpp
-int Board::EvaluateKingSafety(PieceColor color) const {
-    int safety = 0;
-    wxPoint kingPos = GetKingPosition(color);
-    
-    // Kara za króla w centrum
-    int dx = std::abs(kingPos.x - 3.5);
-    int dy = std::abs(kingPos.y - 3.5);
-    int distFromCenter = dx + dy;
-    safety -= (5 - distFromCenter) * 10;
-    
-    // Bonus za roszadę
-    if (color == PieceColor::WHITE && whiteKingMoved) {
-        safety += 30;
-    }
-    if (color == PieceColor::BLACK && blackKingMoved) {
-        safety += 30;
-    }
-    
-    // Kara za brak obrony wokół króla
-    int protection = 0;
-    for (int dx = -1; dx <= 1; dx++) {
-        for (int dy = -1; dy <= 1; dy++) {
-            if (dx == 0 && dy == 0) continue;
-            wxPoint p(kingPos.x + dx, kingPos.y + dy);
-            if (IsInsideBoard(p)) {
-                if (board[p.x][p.y] && board[p.x][p.y]->GetColor() == color) {
-                    protection += 5;
-                }
-            }
-        }
-    }
-    safety += protection;
-    
-    return safety;
-}
-int Board::EvaluateCenterControl(PieceColor color) const {
-    int control = 0;
-    const std::vector<wxPoint> centerSquares = {{3,3}, {3,4}, {4,3}, {4,4}};
-    
-    for (const auto& square : centerSquares) {
-        if (IsSquareUnderAttack(square, color)) {
-            control += 5;
-        }
-    }
-    
-    // Bonus za figury w centrum
-    for (int x = 2; x <= 5; x++) {
-        for (int y = 2; y <= 5; y++) {
-            if (board[x][y] && board[x][y]->GetColor() == color) {
-                if (board[x][y]->GetType() != PieceType::KING) {
-                    control += 3;
-                }
-            }
-        }
-    }
-    
-    return control;
-}
+        Position root = searchRoot;
+        runningGeneration = searchGeneration;
+        searchRequested = false;
+        searchRunning = true;
+        lock.unlock();
 
-int Board::EvaluatePawnStructure(PieceColor color) const {
-    int structure = 0;
-    int doubledPawns = 0;
-    int isolatedPawns = 0;
-    int passedPawns = 0;
-    
-    for (int x = 0; x < 8; x++) {
-        for (int y = 0; y < 8; y++) {
-            if (board[x][y] && board[x][y]->GetType() == PieceType::PAWN && 
-                board[x][y]->GetColor() == color) {
-                
-                // Sprawdź podwójne pionki
-                for (int y2 = 0; y2 < 8; y2++) {
-                    if (y2 != y && board[x][y2] && board[x][y2]->GetType() == PieceType::PAWN && 
-                        board[x][y2]->GetColor() == color) {
-                        doubledPawns++;
-                    }
-                }
-                
-                // Sprawdź izolowane pionki
-                bool hasNeighbor = false;
-                for (int dx = -1; dx <= 1; dx += 2) {
-                    if (x + dx >= 0 && x + dx < 8) {
-                        for (int y2 = 0; y2 < 8; y2++) {
-                            if (board[x+dx][y2] && board[x+dx][y2]->GetType() == PieceType::PAWN && 
-                                board[x+dx][y2]->GetColor() == color) {
-                                hasNeighbor = true;
-                                break;
-                            }
-                        }
-                    }
-                }
-                if (!hasNeighbor) isolatedPawns++;
-                
-                // Sprawdź przechodnie pionki
-                bool isPassed = true;
-                int direction = (color == PieceColor::WHITE) ? -1 : 1;
-                int startY = (color == PieceColor::WHITE) ? y - 1 : y + 1;
-                int endY = (color == PieceColor::WHITE) ? 0 : 7;
-                
-                for (int y2 = startY; y2 != endY; y2 += direction) {
-                    for (int dx = -1; dx <= 1; dx++) {
-                        if (x + dx >= 0 && x + dx < 8) {
-                            if (board[x+dx][y2] && board[x+dx][y2]->GetType() == PieceType::PAWN && 
-                                board[x+dx][y2]->GetColor() != color) {
-                                isPassed = false;
-                                break;
-                            }
-                        }
-                    }
-                    if (!isPassed) break;
-                }
-                
-                if (isPassed) passedPawns++;
-            }
-        }
+        Move move = engine.FindBestMove(root, aiDepth);
+        wxThreadEvent* event = new wxThreadEvent(wxEVT_THREAD, ID_SEARCH_DONE);
+        event->SetInt(move.Raw());
+        event->SetExtraLong(runningGeneration);
+        wxQueueEvent(this, event);
+
+        lock.lock();
+        searchRunning = false;
+        searchCondition.notify_all();
     }
-    
-    structure -= doubledPawns * 10;
-    structure -= isolatedPawns * 15;
-    structure += passedPawns * 20;
-    return structure;
 }
 
-int Board::EvaluateBoard() const {
-    int score = EvaluateMaterial();
-    
-    // Ocena pozycyjna
-    for (int x = 0; x < 8; x++) {
-        for (int y = 0; y < 8; y++) {
-            if (!board[x][y]) continue;
-            
-            Piece* piece = board[x][y].get();
-            int value = 0;
-            PieceColor color = piece->GetColor();
-            bool isPlayerPiece = (color == playerColor);
-
-            // Ocena pozycji pionków
-            if (piece->GetType() == PieceType::PAWN) {
-                int pawnValue = 10;
-                if (color == PieceColor::WHITE) {
-                    // Bonus za pionki bliżej promocji
-                    value = (7 - y) * 5;
-                } else {
-                    value = y * 5;
-                }
-                score += isPlayerPiece ? value : -value;
-            }
-            
-            // Kara za króla na środku planszy
-            if (piece->GetType() == PieceType::KING) {
-                int centerDanger = 0;
-                int dx = std::abs(x - 3.5);
-                int dy = std::abs(y - 3.5);
-                int distFromCenter = dx + dy;
-                
-                if (distFromCenter < 4) {
-                    centerDanger = (4 - distFromCenter) * 20;
-                }
-                score += isPlayerPiece ? -centerDanger : centerDanger;
-            }
-        }
+// Abandons any pending or running search and waits until the engine is
+// idle, so the caller may change the position or the engine afterwards
+void Board::CancelSearch() {
+    std::unique_lock<std::mutex> lock(searchMutex);
+    ++searchGeneration;
+    searchRequested = false;
+    while (searchRunning) {
+        // Repeated because a search that is just starting resets the flag
+        engine.StopSearch();
+        searchCondition.wait_for(lock, std::chrono::milliseconds(1));
     }
-
-    // Bonus za bezpieczeństwo króla
-    int kingSafetyPlayer = EvaluateKingSafety(playerColor);
-    int kingSafetyOpponent = EvaluateKingSafety(
-        (playerColor == PieceColor::WHITE) ? PieceColor::BLACK : PieceColor::WHITE);
-    score += kingSafetyPlayer - kingSafetyOpponent;
-
-    return score;
-}
-int Board::GetPieceValue(PieceType type) const {
-    static std::map<PieceType, int> values = {
-        {PieceType::PAWN, 100},
-        {PieceType::KNIGHT, 320},
-        {PieceType::BISHOP, 330},
-        {PieceType::ROOK, 500},
-        {PieceType::QUEEN, 900},
-        {PieceType::KING, 20000}
-    };
-    return values[type];
+    thinking = false;
 }
 
-// Board.cpp
-int Board::ScoreMove(const wxPoint& from, const wxPoint& to) const {
-    int score = 0;
-    
-    // Bonus za atakowanie figur przeciwnika
-    if (board[to.x][to.y]) {
-        score += GetPieceValue(board[to.x][to.y]->GetType()) * 10;
-    }
-    
-    // Bonus za ucieczkę przed atakiem
-    if (IsSquareUnderAttack(from, (board[from.x][from.y]->GetColor() == PieceColor::WHITE) ? 
-        PieceColor::BLACK : PieceColor::WHITE)) {
-        score += 50;
-    }
-    
-    // Bonus za rozwój figur
-    if (board[from.x][from.y]->GetType() != PieceType::PAWN && 
-        board[from.x][from.y]->GetType() != PieceType::KING) {
-        if (from.y == ((board[from.x][from.y]->GetColor() == PieceColor::WHITE) ? 6 : 1)) {
-            score += 20;
-        }
-    }
-    
-    // Bonus za ruch w kierunku centrum (dla króla)
-    if (board[from.x][from.y]->GetType() == PieceType::KING) {
-        int fromDist = std::abs(from.x - 3.5) + std::abs(from.y - 3.5);
-        int toDist = std::abs(to.x - 3.5) + std::abs(to.y - 3.5);
-        if (toDist > fromDist) {
-            score += 30; // Bonus za oddalenie od centrum
+void Board::ComputerMove() {
+    if (!gameOver && !thinking && IsComputerTurn() && promotionSquare.x == -1) {
+        {
+            std::lock_guard<std::mutex> lock(searchMutex);
+            searchRoot = position;
+            searchRequested = true;
         }
+        thinking = true;
+        searchCondition.notify_all();
     }
-    
-    return score;
-}
-void Board::StartSearchTimer() {
-    searchTimeout = false;
-    searchStartTime = std::chrono::steady_clock::now();
 }
 
-bool Board::IsTimeOut() const {
-    if (searchTimeout) return true;
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::steady_clock::now() - searchStartTime);
-    return elapsed.count() > searchTimeLimit;
-}
-
-void Board::CheckTime() {
-    if (IsTimeOut()) {
-        searchTimeout = true;
+void Board::OnSearchInfo(wxThreadEvent& event) {
+    if (event.GetExtraLong() != searchGeneration) return;
+    if (wxFrame* frame = wxDynamicCast(wxGetTopLevelParent(this), wxFrame)) {
+        frame->SetStatusText(event.GetString());
     }
 }
 
-int Board::MinMax(int depth, int alpha, int beta, bool maximizingPlayer) {
-    if (depth == 0 || gameOver || IsTimeOut()) {
-        return EvaluateBoard();
-    }
-
-    PieceColor currentColor = maximizingPlayer ? playerColor : 
-        (playerColor == PieceColor::WHITE) ? PieceColor::BLACK : PieceColor::WHITE;
-
-    int bestValue = maximizingPlayer ? INT_MIN : INT_MAX;
-    bool foundMove = false;
-
-    // Generuj tylko ruchy dla aktualnego koloru
-    for (int x = 0; x < 8; x++) {
-        for (int y = 0; y < 8; y++) {
-            if (board[x][y] && board[x][y]->GetColor() == currentColor) {
-                wxPoint from(x, y);
-                auto moves = board[x][y]->GetPossibleMoves(*this, from);
-                
-                // Sortuj ruchy według oceny
-                std::vector<std::pair<wxPoint, int>> scoredMoves;
-                for (const auto& to : moves) {
-                    if (IsMoveLegal(from, to)) {
-                        scoredMoves.push_back({to, ScoreMove(from, to)});
-                    }
-                }
-                std::sort(scoredMoves.begin(), scoredMoves.end(),
-                    [](const auto& a, const auto& b) { return a.second > b.second; });
-                
-                for (const auto& [to, score] : scoredMoves) {
-                    foundMove = true;
-                    MoveState savedState;
-                    GetCurrentState(savedState);
-                    DoMove(from, to);
-
-                    int value = MinMax(depth - 1, alpha, beta, !maximizingPlayer);
-                    
-                    RestoreState(savedState);
-
-                    if (maximizingPlayer) {
-                        if (value > bestValue) bestValue = value;
-                        alpha = std::max(alpha, bestValue);
-                    } else {
-                        if (value < bestValue) bestValue = value;
-                        beta = std::min(beta, bestValue);
-                    }
-
-                    // Przycinanie alfa-beta
-                    if (beta <= alpha) {
-                        return bestValue;
-                    }
-                }
-            }
-        }
-    }
-
-    if (!foundMove) {
-        // Brak legalnych ruchów - sprawdź szach/mat
-        if (IsKingInCheck(currentColor)) {
-            return maximizingPlayer ? INT_MIN + 1000 : INT_MAX - 1000;
-        }
-        return 0; // Remis
-    }
-    
-    return bestValue;
-}
-// Board.cpp
-std::pair<wxPoint, wxPoint> Board::FindBestMove(int depth) {
-    StartSearchTimer();
-    int bestValue = INT_MIN;
-    std::pair<wxPoint, wxPoint> bestMove = {{-1, -1}, {-1, -1}};
-    int alpha = INT_MIN;
-    int beta = INT_MAX;
-
-    // Generuj ruchy przeciwnika (AI)
-    for (int x = 0; x < 8; x++) {
-        for (int y = 0; y < 8; y++) {
-            if (board[x][y] && board[x][y]->GetColor() != playerColor) {
-                wxPoint from(x, y);
-                auto moves = board[x][y]->GetPossibleMoves(*this, from);
-                
-                // Sortuj ruchy według oceny
-                std::vector<std::pair<wxPoint, int>> scoredMoves;
-                for (const auto& to : moves) {
-                    if (IsMoveLegal(from, to)) {
-                        scoredMoves.push_back({to, ScoreMove(from, to)});
-                    }
-                }
-                std::sort(scoredMoves.begin(), scoredMoves.end(),
-                    [](const auto& a, const auto& b) { return a.second > b.second; });
-                
-                for (const auto& [to, score] : scoredMoves) {
-                    if (IsTimeOut()) {
-                        return bestMove;
-                    }
-                    
-                    MoveState savedState;
-                    GetCurrentState(savedState);
-                    DoMove(from, to);
-
-                    int value = MinMax(depth - 1, alpha, beta, false);
-                    
-                    RestoreState(savedState);
-
-                    if (value > bestValue) {
-                        bestValue = value;
-                        bestMove = {from, to};
-                    }
-                    
-                    alpha = std::max(alpha, bestValue);
-                }
-            }
-        }
-    }
+void Board::OnSearchFinished(wxThreadEvent& event) {
+    if (event.GetExtraLong() != searchGeneration || !thinking) return;
+    thinking = false;
 
-    return bestMove;
-}
-void Board::ComputerMove() {
     if (!gameOver && IsComputerTurn() && promotionSquare.x == -1) {
-        auto move = FindBestMove(aiDepth);
-        if (move.first.x != -1) {
-            SaveState();
-            DoMove(move.first, move.second);
+        Move move = Move::FromRaw(uint16_t(event.GetInt()));
+        if (!move.IsNone()) {
+            DoMove(move);
 
             // Sprawdź stan gry po ruchu
-            PieceColor opponent = (currentTurn == PieceColor::WHITE) ? 
-                PieceColor::BLACK : PieceColor::WHITE;
+            PieceColor opponent = GetCurrentTurn();
                 
             if (IsCheckmate(opponent)) {
-                ShowGameOverDialog("Checkmate! " + wxString(opponent == PieceColor::WHITE ? "White" : "Black") + " wins!");
+                ShowGameOverDialog("Checkmate! " + wxString(opponent == PieceColor::WHITE ? "Black" : "White") + " wins!");
             } else if (IsStalemate(opponent)) {
                 ShowGameOverDialog("Stalemate! Game drawn!");
             }
@@ -846,11 +386,38 @@ void Board::ComputerMove() {
 }
 
 void Board::UndoLastMove() {
-    if (moveHistory.size() <= 1) return;
-    
-    moveHistory.pop();
-    RestoreState(moveHistory.top());
+    // The computer's reply goes together with the player's move
+    size_t ply = historyPly;
+    do {
+        if (ply == 0) return;
+        --ply;
+    } while (SideToMoveAtPly(ply) != playerColor);
+    CancelSearch();
+
+    GoToPly(ply);
+    Refresh();
+}
+
+void Board::RedoMove() {
+    if (historyPly == history.size()) return;
+    size_t ply = historyPly;
+    do {
+        ++ply;
+    } while (ply < history.size() && SideToMoveAtPly(ply) != playerColor);
+    CancelSearch();
+
+    GoToPly(ply);
+    // Replaying into a finished game shows its result again, without the dialog
+    PieceColor toMove = GetCurrentTurn();
+    if (IsCheckmate(toMove)) {
+        gameOver = true;
+        gameResult = "Checkmate! " + wxString(toMove == PieceColor::WHITE ? "Black" : "White") + " wins!";
+    } else if (IsStalemate(toMove)) {
+        gameOver = true;
+        gameResult = "Stalemate! Game drawn!";
+    }
     Refresh();
+    ComputerMove();
 }
 
 void Board::ShowGameOverDialog(wxString message) {
@@ -876,46 +443,19 @@ void Board::SetRandomColor() {
 }
 
 void Board::InitNewGame() {
-    whiteKingMoved = false;
-    blackKingMoved = false;
-    whiteRookKMoved = false;
-    whiteRookQMoved = false;
-    blackRookKMoved = false;
-    blackRookQMoved = false;
-    enPassantTarget = wxPoint(-1, -1);
+    CancelSearch();
     selectedPiece = wxPoint(-1, -1);
     possibleMoves.clear();
-    currentTurn = PieceColor::WHITE;
-    whiteKingPos = wxPoint(4, 7);
-    blackKingPos = wxPoint(4, 0);
     gameOver = false;
     gameResult = "";
     promotionSquare = wxPoint(-1, -1);
     
-    while (!moveHistory.empty()) {
-        moveHistory.pop();
-    }
-
-    for (int x = 0; x < 8; ++x)
-        for (int y = 0; y < 8; ++y)
-            board[x][y].reset();
-
-    for (int x = 0; x < 8; ++x) {
-        board[x][1] = PieceFactory::CreatePiece(PieceType::PAWN, PieceColor::BLACK);
-        board[x][6] = PieceFactory::CreatePiece(PieceType::PAWN, PieceColor::WHITE);
-    }
-
-    PieceType backRow[8] = {
-        PieceType::ROOK, PieceType::KNIGHT, PieceType::BISHOP, PieceType::QUEEN,
-        PieceType::KING, PieceType::BISHOP, PieceType::KNIGHT, PieceType::ROOK
-    };
-
-    for (int x = 0; x < 8; ++x) {
-        board[x][0] = PieceFactory::CreatePiece(backRow[x], PieceColor::BLACK);
-        board[x][7] = PieceFactory::CreatePiece(backRow[x], PieceColor::WHITE);
-    }
-    
-    SaveState();
+    position.SetStartPosition();
+    history.clear();
+    historyPly = 0;
+    checkpoints.assign(1, position);
+    UpdatePiecesFromPosition();
+    engine.ClearHash();
 }
 
 void Board::OnPaint(wxPaintEvent& event) {
@@ -980,7 +520,8 @@ void Board::OnPaint(wxPaintEvent& event) {
 }
 
 void Board::OnLeftDown(wxMouseEvent& event) {
-    if (gameOver) return;
+    // The board is not the player's while the engine is thinking
+    if (gameOver || thinking) return;
 
     // Jeśli trwa promocja, obsłuż wybór figury
     if (promotionSquare.x != -1) {
@@ -994,11 +535,10 @@ void Board::OnLeftDown(wxMouseEvent& event) {
             Refresh();
             
             // Po promocji sprawdź stan gry
-            PieceColor opponent = (currentTurn == PieceColor::WHITE) ? 
-                PieceColor::BLACK : PieceColor::WHITE;
+            PieceColor opponent = GetCurrentTurn();
                 
             if (IsCheckmate(opponent)) {
-                ShowGameOverDialog("Checkmate! " + wxString(currentTurn == PieceColor::WHITE ? "White" : "Black") + " wins!");
+                ShowGameOverDialog("Checkmate! " + wxString(opponent == PieceColor::WHITE ? "Black" : "White") + " wins!");
             } else if (IsStalemate(opponent)) {
                 ShowGameOverDialog("Stalemate! Game drawn!");
             }
@@ -1014,24 +554,15 @@ void Board::OnLeftDown(wxMouseEvent& event) {
         return;
 
     if (selectedPiece.x == -1) {
-        if (board[x][y] && board[x][y]->GetColor() == currentTurn) {
+        if (board[x][y] && board[x][y]->GetColor() == GetCurrentTurn()) {
             selectedPiece = wxPoint(x, y);
-            possibleMoves = board[x][y]->GetPossibleMoves(*this, selectedPiece);
-            
-            std::vector<wxPoint> legalMoves;
-            for (const auto& move : possibleMoves) {
-                if (IsMoveLegal(selectedPiece, move)) {
-                    legalMoves.push_back(move);
-                }
-            }
-            possibleMoves = legalMoves;
+            possibleMoves = GetLegalMoves(selectedPiece);
         }
     } else {
         wxPoint dest(x, y);
         auto it = std::find(possibleMoves.begin(), possibleMoves.end(), dest);
         if (it != possibleMoves.end()) {
-            SaveState();
-            DoMove(selectedPiece, dest);
+            DoMove(FindLegalMove(selectedPiece, dest));
             
             PieceColor movedColor = board[dest.x][dest.y]->GetColor();
             PieceColor opponent = (movedColor == PieceColor::WHITE) ? 
@@ -7,7 +7,6 @@
 #include <vector>
 #include <memory>
 #include <random>
-#include <stack>
 #include <map>
 #include <climits>
 #include <algorithm>
@@ -16,25 +15,33 @@
 #include <chrono>
 #include <future>
 #include <mutex>
+#include <thread>
+#include <condition_variable>
 #include "Piece.h"
+#include "Position.h"
+#include "Engine.h"
 
 class Board : public wxPanel {
 public:
     explicit Board(wxWindow* parent);
+    ~Board();
     void InitNewGame();
     void ResetGame();
     void SetRandomColor();
+    // Take back or replay moves up to the player's next turn
     void UndoLastMove();
+    void RedoMove();
 
     bool IsEmpty(int x, int y) const;
     bool IsEnemy(int x, int y, PieceColor color) const;
     bool IsValidMove(int fromX, int fromY, int toX, int toY) const;
     bool IsInsideBoard(wxPoint p) const { return p.x >= 0 && p.x < 8 && p.y >= 0 && p.y < 8; }
-    Piece* GetPieceAt(wxPoint p) const;
+    const Piece* GetPieceAt(wxPoint p) const;
+    std::vector<wxPoint> GetLegalMoves(wxPoint from) const;
     bool IsRook(int x, int y, PieceColor color) const;
-    wxPoint GetEnPassantTarget() const { return enPassantTarget; }
-    void SetEnPassantTarget(wxPoint target) { enPassantTarget = target; }
-    bool IsEnPassantTarget(int x, int y) const { return enPassantTarget == wxPoint(x, y); }
+    wxPoint GetEnPassantTarget() const;
+    void SetEnPassantTarget(wxPoint target);
+    bool IsEnPassantTarget(int x, int y) const { return GetEnPassantTarget() == wxPoint(x, y); }
     bool CanCastleKingside(PieceColor color) const;
     bool CanCastleQueenside(PieceColor color) const;
     void SetKingMoved(PieceColor color);
@@ -46,95 +53,77 @@ public:
     bool HasLegalMoves(PieceColor color);
     void ShowGameOverDialog(wxString message);
 
-    PieceColor GetCurrentTurn() const { return currentTurn; }
+    PieceColor GetCurrentTurn() const { return position.GetSideToMove(); }
 
     wxPoint GetKingPosition(PieceColor color) const;
     std::vector<wxPoint> GetCheckingPieces(PieceColor color) const;
     bool IsMoveLegal(wxPoint from, wxPoint to);
-    bool IsComputerTurn() const { return currentTurn != playerColor; }
+    bool IsComputerTurn() const { return GetCurrentTurn() != playerColor; }
     void PromotePawn(wxPoint pos, PieceType promotionType = PieceType::QUEEN);
 
 private:
     void OnPaint(wxPaintEvent& event);
     void OnLeftDown(wxMouseEvent& event);
     void HighlightChecks(wxAutoBufferedPaintDC& dc) const;
-    void DoMove(wxPoint from, wxPoint to);
+    void DoMove(Move move);
+    Move FindLegalMove(wxPoint from, wxPoint to);
     void ComputerMove();
+    void OnSearchFinished(wxThreadEvent& event);
+    void OnSearchInfo(wxThreadEvent& event);
+    void SearchThreadLoop();
+    void CancelSearch();
     void HandlePawnPromotion(wxPoint pos);
-    
-    struct MoveState {
-        std::unique_ptr<Piece> board[8][8];
-        wxPoint selectedPiece;
-        PieceColor currentTurn;
-        wxPoint enPassantTarget;
-        wxPoint whiteKingPos;
-        wxPoint blackKingPos;
-        bool whiteKingMoved;
-        bool blackKingMoved;
-        bool whiteRookKMoved;
-        bool whiteRookQMoved;
-        bool blackRookKMoved;
-        bool blackRookQMoved;
-        wxPoint promotionSquare;
-    };
-    
-    void SaveState();
-    void RestoreState(const MoveState& state);
-    void GetCurrentState(MoveState& state) const;
-    
-    std::pair<wxPoint, wxPoint> FindBestMove(int depth);
-    int MinMax(int depth, int alpha, int beta, bool maximizingPlayer);
-    int EvaluateBoard() const;
-    int EvaluateMaterial() const;
-    int EvaluateMobility(PieceColor color) const;
-    int EvaluateKingSafety(PieceColor color) const;
-    int EvaluateCenterControl(PieceColor color) const;
-    int EvaluatePawnStructure(PieceColor color) const;
-    
-    // Time management functions
-    void StartSearchTimer();
-    bool IsTimeOut() const;
-    void CheckTime();
-    
-    // Move scoring
-    int ScoreMove(const wxPoint& from, const wxPoint& to) const;
-    int GetPieceValue(PieceType type) const;
+    void UpdatePiecesFromPosition();
+    PieceColor SideToMoveAtPly(size_t ply) const;
+    void GoToPly(size_t ply);
 
     wxSize tileSize = wxSize(60, 60);
-    std::unique_ptr<Piece> board[8][8];
+    // Rules state; the piece objects below are only derived from it for drawing
+    Position position;
+    // Shared instances from PieceFactory, not owned
+    const Piece* board[8][8] = {};
     wxPoint selectedPiece = wxPoint(-1, -1);
-    PieceColor currentTurn = PieceColor::WHITE;
     PieceColor playerColor = PieceColor::WHITE;
     std::vector<wxPoint> possibleMoves;
-    wxPoint enPassantTarget = wxPoint(-1, -1);
     wxPoint promotionSquare = wxPoint(-1, -1);
 
-    // King positions for quick access
-    wxPoint whiteKingPos = wxPoint(4, 7);
-    wxPoint blackKingPos = wxPoint(4, 0);
-
     // Game state flags
     bool gameOver = false;
     wxString gameResult = "";
 
-    // Castling flags
-    bool whiteKingMoved = false;
-    bool blackKingMoved = false;
-    bool whiteRookKMoved = false;
-    bool whiteRookQMoved = false;
-    bool blackRookKMoved = false;
-    bool blackRookQMoved = false;
-
     // AI settings
-    int aiDepth = 4;
+    Engine engine;
+    // Depth cap only; the engine deepens until its time limit runs out
+    int aiDepth = MAX_SEARCH_DEPTH;
 
-    // Time management
-    std::atomic<bool> searchTimeout{false};
-    std::chrono::steady_clock::time_point searchStartTime;
-    int searchTimeLimit = 3000; // 5-second limit
+    // Move history: the moves from the start position with what UnmakeMove
+    // needs to take them back (including the key before the move). Entries
+    // from historyPly on were undone and are kept for redo until another move
+    // is played. A full copy of the position is kept only every
+    // CHECKPOINT_INTERVAL plies, for jumps longer than that.
+    struct HistoryEntry {
+        Move move;
+        UndoInfo undo;
+    };
+    static constexpr size_t CHECKPOINT_INTERVAL = 32;
+    std::vector<HistoryEntry> history;
+    size_t historyPly = 0;
+    std::vector<Position> checkpoints;   // position at ply i * CHECKPOINT_INTERVAL
 
-    // Move history
-    std::stack<MoveState> moveHistory;
+    // Background search. The worker thread lives as long as the board and
+    // searches a copy of the position; results come back as wxThreadEvents.
+    // searchGeneration changes whenever the game moves on without the
+    // engine, so results of abandoned searches are ignored.
+    std::thread searchThread;
+    std::mutex searchMutex;
+    std::condition_variable searchCondition;
+    Position searchRoot;
+    long searchGeneration = 0;
+    long runningGeneration = 0;
+    bool searchRequested = false;
+    bool searchRunning = false;
+    bool quitSearchThread = false;
+    bool thinking = false;   // UI thread only: a search was requested and has not answered
 
     wxDECLARE_EVENT_TABLE();
 };
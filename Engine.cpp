@@ -0,0 +1,145 @@
+#include "Engine.h"
+#include "MoveGen.h"
+#include <algorithm>
+
+Engine::Engine() {
+    SetThreads(1);
+}
+
+Engine::~Engine() {
+    StopHelperThreads();
+}
+
+void Engine::SetThreads(int count) {
+    StopHelperThreads();
+    workers.clear();
+
+    count = std::max(1, count);
+    for (int i = 0; i < count; ++i) {
+        workers.push_back(std::make_unique<SearchWorker>(*this, i));
+    }
+    quitHelpers = false;
+    for (int i = 1; i < count; ++i) {
+        helpers.emplace_back(&Engine::HelperLoop, this, std::ref(*workers[i]));
+    }
+}
+
+void Engine::ClearHash() {
+    tt.Clear();
+    for (auto& worker : workers) worker->ClearHistory();
+}
+
+bool Engine::LoadNetwork(const std::string& path) {
+    std::unique_ptr<Network> loaded(new Network());
+    if (!loaded->Load(path)) return false;
+    network = std::move(loaded);
+    // Cached scores came from the previous evaluation
+    evalCache.Clear();
+    return true;
+}
+
+void Engine::UseClassicalEvaluation() {
+    network.reset();
+    evalCache.Clear();
+}
+
+void Engine::StopHelperThreads() {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        quitHelpers = true;
+    }
+    poolCondition.notify_all();
+    for (std::thread& helper : helpers) helper.join();
+    helpers.clear();
+}
+
+void Engine::HelperLoop(SearchWorker& worker) {
+    uint64_t lastSearch = 0;
+    std::unique_lock<std::mutex> lock(poolMutex);
+    while (true) {
+        poolCondition.wait(lock, [&] { return quitHelpers || searchId != lastSearch; });
+        if (quitHelpers) return;
+
+        lastSearch = searchId;
+        Position root = helperRoot;
+        int depth = helperDepth;
+        lock.unlock();
+
+        worker.Search(root, depth);
+
+        lock.lock();
+        if (--helpersRunning == 0) poolCondition.notify_all();
+    }
+}
+
+void Engine::ReportIteration(const SearchWorker& main) {
+    if (!infoCallback) return;
+
+    SearchInfo info;
+    info.depth = main.GetCompletedDepth();
+    info.score = main.GetBestScore();
+    info.nodes = 0;
+    info.evalProbes = 0;
+    info.evalHits = 0;
+    for (const auto& worker : workers) {
+        info.threadNodes.push_back(worker->GetNodes());
+        info.nodes += worker->GetNodes();
+        info.evalProbes += worker->GetEvalProbes();
+        info.evalHits += worker->GetEvalHits();
+    }
+    info.elapsedMs = int(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - searchStartTime).count());
+    info.pv = main.GetPrincipalVariation();
+    infoCallback(info);
+}
+
+void Engine::StartSearchTimer() {
+    searchTimeout = false;
+    searchStartTime = std::chrono::steady_clock::now();
+}
+
+void Engine::CheckTime() {
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - searchStartTime);
+    if (elapsed.count() > searchTimeLimit) {
+        searchTimeout = true;
+    }
+}
+
+Move Engine::FindBestMove(const Position& root, int maxDepth) {
+    StartSearchTimer();
+    tt.NewSearch();
+
+    MoveList rootMoves;
+    GenerateLegalMoves(root, rootMoves);
+    if (rootMoves.Empty()) return Move::None();
+    maxDepth = std::min(maxDepth, MAX_SEARCH_DEPTH);
+
+    for (auto& worker : workers) worker->ResetCounters();
+    // Nothing to choose; still replace the previous search's PV and depth
+    if (rootMoves.Size() == 1) {
+        workers[0]->SetForcedMove(root, rootMoves[0]);
+        ReportIteration(*workers[0]);
+        return rootMoves[0];
+    }
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        helperRoot = root;
+        helperDepth = maxDepth;
+        helpersRunning = int(helpers.size());
+        ++searchId;
+    }
+    poolCondition.notify_all();
+
+    workers[0]->Search(root, maxDepth);
+
+    // Only the main thread's result counts; stop the helpers once it has one
+    searchTimeout = true;
+    {
+        std::unique_lock<std::mutex> lock(poolMutex);
+        poolCondition.wait(lock, [this] { return helpersRunning == 0; });
+    }
+
+    Move bestMove = workers[0]->GetBestMove();
+    return bestMove.IsNone() ? rootMoves[0] : bestMove;
+}
@@ -0,0 +1,116 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "Move.h"
+#include "Position.h"
+#include "EvalCache.h"
+#include "Nnue.h"
+#include "SearchWorker.h"
+#include "TranspositionTable.h"
+
+// Progress report sent after every completed iteration of the main thread.
+// The score is from the point of view of the side to move at the root.
+struct SearchInfo {
+    int depth;
+    int score;
+    uint64_t nodes;
+    int elapsedMs;
+    std::vector<Move> pv;
+    std::vector<uint64_t> threadNodes;
+    // Evaluation cache lookups of all threads, and hits among them
+    uint64_t evalProbes;
+    uint64_t evalHits;
+};
+
+// Alpha-beta search and static evaluation. Works on its own copies of the
+// position, so it has no dependency on the GUI board. The calling thread
+// searches as thread 0; helper threads are kept in a pool between searches.
+class Engine {
+public:
+    Engine();
+    ~Engine();
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    // Returns the best move for the side to move, or Move::None() if there
+    // is none. Searches depth 1, 2, ... up to maxDepth and answers with the
+    // last iteration that finished within the time limit.
+    Move FindBestMove(const Position& root, int maxDepth);
+    // Principal variation and depth of the last completed iteration
+    const std::vector<Move>& GetPrincipalVariation() const { return workers[0]->GetPrincipalVariation(); }
+    int GetCompletedDepth() const { return workers[0]->GetCompletedDepth(); }
+    // Called on the searching thread, so it must not touch the GUI directly
+    void SetInfoCallback(std::function<void(const SearchInfo&)> callback) { infoCallback = std::move(callback); }
+
+    // Number of search threads including the caller's; not while searching
+    void SetThreads(int count);
+    int GetThreads() const { return int(workers.size()); }
+
+    void SetSearchTimeLimit(int milliseconds) { searchTimeLimit = milliseconds; }
+    int GetSearchTimeLimit() const { return searchTimeLimit; }
+    void StopSearch() { searchTimeout = true; }
+
+    // Not while searching
+    void SetPruningParams(const PruningParams& params) { pruning = params; }
+    const PruningParams& GetPruningParams() const { return pruning; }
+
+    // The transposition table persists between searches so each move
+    // starts from what the previous one learned
+    void SetHashSize(size_t megabytes) { tt.Resize(megabytes); }
+    // Also forgets the workers' move ordering statistics, for a new game
+    void ClearHash();
+
+    // Evaluates with the network from 'path' instead of the classical
+    // evaluation; on failure keeps the evaluation in use. Not while searching.
+    bool LoadNetwork(const std::string& path);
+    void UseClassicalEvaluation();
+    bool UsesNetwork() const { return network != nullptr; }
+
+private:
+    friend class SearchWorker;
+
+    void HelperLoop(SearchWorker& worker);
+    void StopHelperThreads();
+    void ReportIteration(const SearchWorker& main);
+
+    // Time management functions. IsTimeOut only reads the stop flag, so it
+    // is cheap enough for every node; CheckTime reads the clock and sets it.
+    void StartSearchTimer();
+    bool IsTimeOut() const { return searchTimeout.load(std::memory_order_relaxed); }
+    void CheckTime();
+
+    TranspositionTable tt;
+    EvalCache evalCache;
+    std::unique_ptr<Network> network;
+    PruningParams pruning;
+    std::vector<std::unique_ptr<SearchWorker>> workers;
+    std::function<void(const SearchInfo&)> infoCallback;
+
+    // Helper thread pool; a new searchId wakes the helpers for a search
+    std::vector<std::thread> helpers;
+    std::mutex poolMutex;
+    std::condition_variable poolCondition;
+    Position helperRoot;
+    int helperDepth = 0;
+    uint64_t searchId = 0;
+    int helpersRunning = 0;
+    bool quitHelpers = false;
+
+    // Time management
+    std::atomic<bool> searchTimeout{false};
+    std::chrono::steady_clock::time_point searchStartTime;
+    int searchTimeLimit = 3000;
+};
+
+#endif // ENGINE_H
@@ -0,0 +1,33 @@
+#ifndef EVALCACHE_H
+#define EVALCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include "HashTable.h"
+
+// Direct-mapped cache of static evaluations by position key, shared by all
+// search threads. Lossy: a new store simply overwrites the slot.
+class EvalCache {
+public:
+    explicit EvalCache(size_t megabytes = 4) : table(megabytes) {}
+
+    // Reallocates (and empties) the cache; rounded down to a power of two
+    void Resize(size_t megabytes) { table.Resize(megabytes); }
+    void Clear() { table.Clear(); }
+
+    bool Probe(uint64_t key, int& score) const {
+        uint64_t data;
+        if (!table.BucketFor(key).slots[0].Probe(key, data)) return false;
+        score = int32_t(uint32_t(data));
+        return true;
+    }
+
+    void Store(uint64_t key, int score) {
+        table.BucketFor(key).slots[0].Store(key, uint32_t(score));
+    }
+
+private:
+    LockFreeHashTable<1> table;
+};
+
+#endif // EVALCACHE_H
@@ -0,0 +1,71 @@
+#include "Evaluation.h"
+#include <algorithm>
+
+int ClassicalEvaluator::EvaluateKingSafety(const Position& position, PieceColor color) const {
+    int safety = 0;
+    Square kingPos = position.GetKingSquare(color);
+    int kx = FileOf(kingPos);
+    int ky = RankOf(kingPos);
+
+    // Bonus za roszadę
+    if (!position.HasCastlingRights(color)) {
+        safety += 30;
+    }
+
+    // Kara za brak obrony wokół króla
+    int protection = 0;
+    for (int dx = -1; dx <= 1; dx++) {
+        for (int dy = -1; dy <= 1; dy++) {
+            if (dx == 0 && dy == 0) continue;
+            if (!IsInsideBoard(kx + dx, ky + dy)) continue;
+            Square s = MakeSquare(kx + dx, ky + dy);
+            if (!position.IsEmpty(s) && position.GetPieceColor(s) == color) {
+                protection += 5;
+            }
+        }
+    }
+    safety += protection;
+
+    return safety;
+}
+
+// Rooks on files without pawns, or without their own side's pawns; added
+// to White's side of the scores
+void ClassicalEvaluator::EvaluateRookFiles(const Position& position, PieceColor color, const PawnEntry& pawns, int& midgame, int& endgame) const {
+    int sign = (color == PieceColor::WHITE) ? 1 : -1;
+    Bitboard rooks = position.Pieces(PieceType::ROOK, color);
+    while (rooks) {
+        int fileBit = 1 << FileOf(PopLsb(rooks));
+        if (pawns.openFiles & fileBit) {
+            midgame += sign * 25;
+            endgame += sign * 10;
+        } else if (pawns.semiOpenFiles[int(color)] & fileBit) {
+            midgame += sign * 10;
+            endgame += sign * 5;
+        }
+    }
+}
+
+int ClassicalEvaluator::Evaluate(const Position& position) {
+    PieceColor us = position.GetSideToMove();
+
+    // Material and piece placement come ready from the position, pawn
+    // structure from the pawn table; everything here is from White's side
+    const PawnEntry& pawns = pawnTable.Probe(position);
+    int midgame = position.GetMidgameScore() + pawns.midgame;
+    int endgame = position.GetEndgameScore() + pawns.endgame;
+    EvaluateRookFiles(position, PieceColor::WHITE, pawns, midgame, endgame);
+    EvaluateRookFiles(position, PieceColor::BLACK, pawns, midgame, endgame);
+
+    // The middlegame and endgame scores are blended by the material left
+    int phase = std::min(position.GetPhase(), MAX_PHASE);
+    int score = (midgame * phase + endgame * (MAX_PHASE - phase)) / MAX_PHASE;
+    if (us == PieceColor::BLACK) score = -score;
+
+    // Bonus za bezpieczeństwo króla, only while there are pieces to attack it
+    int kingSafetyEngine = EvaluateKingSafety(position, us);
+    int kingSafetyOpponent = EvaluateKingSafety(position, Opponent(us));
+    score += (kingSafetyEngine - kingSafetyOpponent) * phase / MAX_PHASE;
+
+    return score;
+}
@@ -0,0 +1,23 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include "PawnTable.h"
+#include "Position.h"
+
+// Hand-written evaluation: tapered material and piece-square scores kept by
+// the position, pawn structure from a pawn table, rook files and king
+// safety. Scores are in centipawns for the side to move. Holds a pawn table,
+// so every search thread needs its own.
+class ClassicalEvaluator {
+public:
+    int Evaluate(const Position& position);
+
+private:
+    int EvaluateKingSafety(const Position& position, PieceColor color) const;
+    void EvaluateRookFiles(const Position& position, PieceColor color, const PawnEntry& pawns,
+                           int& midgame, int& endgame) const;
+
+    PawnTable pawnTable;
+};
+
+#endif // EVALUATION_H
@@ -0,0 +1,76 @@
+#ifndef HASHTABLE_H
+#define HASHTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// One 64-bit payload stored under a 64-bit position key. Tables of these are
+// shared by threads without locks: a slot stores key ^ data next to data,
+// so a slot torn by two concurrent writers fails the key check instead of
+// handing out another position's data.
+struct HashSlot {
+    std::atomic<uint64_t> keyXorData;
+    std::atomic<uint64_t> data;
+
+    uint64_t Data() const { return data.load(std::memory_order_relaxed); }
+    // Whether 'data', as read from this slot, belongs to 'key'
+    bool Holds(uint64_t key, uint64_t data) const {
+        return (keyXorData.load(std::memory_order_relaxed) ^ data) == key;
+    }
+    bool Probe(uint64_t key, uint64_t& result) const {
+        uint64_t value = Data();
+        if (!Holds(key, value)) return false;
+        result = value;
+        return true;
+    }
+    void Store(uint64_t key, uint64_t value) {
+        data.store(value, std::memory_order_relaxed);
+        keyXorData.store(key ^ value, std::memory_order_relaxed);
+    }
+    void Clear() {
+        data.store(0, std::memory_order_relaxed);
+        keyXorData.store(0, std::memory_order_relaxed);
+    }
+};
+
+// Power-of-two array of buckets of 'Ways' slots, indexed by the low bits of
+// the key. What goes into a slot and which slot of a bucket to replace is
+// up to the user.
+template <int Ways>
+class LockFreeHashTable {
+public:
+    static_assert(Ways > 0 && (Ways & (Ways - 1)) == 0, "bucket size must be a power of two");
+
+    // Aligned to its own size, so a four-slot bucket is one cache line
+    struct alignas(Ways * sizeof(HashSlot)) Bucket {
+        HashSlot slots[Ways];
+    };
+
+    explicit LockFreeHashTable(size_t megabytes) { Resize(megabytes); }
+
+    // Reallocates (and empties) the table; the size is rounded down to a
+    // power-of-two number of buckets
+    void Resize(size_t megabytes) {
+        size_t count = 1;
+        while (count * 2 * sizeof(Bucket) <= megabytes * 1024 * 1024) count *= 2;
+        buckets.reset(new Bucket[count]());
+        mask = count - 1;
+    }
+
+    void Clear() {
+        for (size_t i = 0; i <= mask; ++i) {
+            for (HashSlot& slot : buckets[i].slots) slot.Clear();
+        }
+    }
+
+    Bucket& BucketFor(uint64_t key) { return buckets[key & mask]; }
+    const Bucket& BucketFor(uint64_t key) const { return buckets[key & mask]; }
+
+private:
+    std::unique_ptr<Bucket[]> buckets;
+    size_t mask = 0;
+};
+
+#endif // HASHTABLE_H
@@ -1,5 +1,4 @@
 #include "Knight.h"
-#include "Board.h"
 
 Knight::Knight(PieceColor color) : Piece(PieceType::KNIGHT, color) {}
 
@@ -10,24 +9,3 @@ wxString Knight::GetSymbol() const {
 std::string Knight::GetName() const {
     return "Knight";
 }
-
-std::vector<wxPoint> Knight::GetPossibleMoves(const Board& board, wxPoint position) const {
-    std::vector<wxPoint> moves;
-    const int moveset[8][2] = {
-        {2, 1}, {1, 2}, {-1, 2}, {-2, 1},
-        {-2, -1}, {-1, -2}, {1, -2}, {2, -1}
-    };
-    
-    for (const auto& move : moveset) {
-        int nx = position.x + move[0];
-        int ny = position.y + move[1];
-        
-        if (nx >= 0 && nx < 8 && ny >= 0 && ny < 8) {
-            if (board.IsEmpty(nx, ny) || board.IsEnemy(nx, ny, GetColor())) {
-                moves.push_back(wxPoint(nx, ny));
-            }
-        }
-    }
-    
-    return moves;
-}
@@ -10,7 +10,6 @@ public:
     Knight(PieceColor color);
     wxString GetSymbol() const override;
     std::string GetName() const override;
-    std::vector<wxPoint> GetPossibleMoves(const Board& board, wxPoint position) const override;
 };
 
 #endif
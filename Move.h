@@ -0,0 +1,97 @@
+#ifndef MOVE_H
+#define MOVE_H
+
+#include <cstdint>
+#include <string>
+#include "Types.h"
+
+// Move kind, stored in the top four bits of a Move.
+enum MoveFlag : uint16_t {
+    QUIET = 0,
+    DOUBLE_PAWN_PUSH = 1,
+    KING_CASTLE = 2,
+    QUEEN_CASTLE = 3,
+    CAPTURE = 4,
+    EN_PASSANT = 5,
+    PROMOTION = 8,   // low two bits select knight, bishop, rook or queen
+    PROMOTION_CAPTURE = PROMOTION | CAPTURE
+};
+
+// A move packed into 16 bits: from (6), to (6), flags (4).
+class Move {
+public:
+    Move() = default;
+    constexpr Move(Square from, Square to, uint16_t flags = QUIET)
+        : data(uint16_t(from | (to << 6) | (flags << 12))) {}
+
+    static constexpr Move None() { return Move(0, 0); }
+    static constexpr Move FromRaw(uint16_t raw) { return Move(raw & 63, (raw >> 6) & 63, raw >> 12); }
+    static Move Promotion(Square from, Square to, PieceType type, bool capture) {
+        uint16_t kind = (type == PieceType::KNIGHT) ? 0 : (type == PieceType::BISHOP) ? 1
+                      : (type == PieceType::ROOK) ? 2 : 3;
+        return Move(from, to, (capture ? PROMOTION_CAPTURE : PROMOTION) | kind);
+    }
+
+    Square From() const { return data & 63; }
+    Square To() const { return (data >> 6) & 63; }
+    uint16_t Flags() const { return data >> 12; }
+
+    bool IsCapture() const { return Flags() & CAPTURE; }
+    bool IsPromotion() const { return Flags() & PROMOTION; }
+    bool IsEnPassant() const { return Flags() == EN_PASSANT; }
+    bool IsCastle() const { return Flags() == KING_CASTLE || Flags() == QUEEN_CASTLE; }
+    PieceType PromotionType() const {
+        static constexpr PieceType types[4] = {
+            PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN
+        };
+        return IsPromotion() ? types[Flags() & 3] : PieceType::NONE;
+    }
+
+    // Coordinate notation, e.g. "e2e4" or "e7e8q"
+    std::string ToString() const {
+        std::string s = {
+            char('a' + FileOf(From())), char('1' + RankOf(From())),
+            char('a' + FileOf(To())), char('1' + RankOf(To()))
+        };
+        if (IsPromotion()) s += "nbrq"[Flags() & 3];
+        return s;
+    }
+
+    uint16_t Raw() const { return data; }
+    bool IsNone() const { return data == 0; }
+    bool operator==(Move other) const { return data == other.data; }
+    bool operator!=(Move other) const { return data != other.data; }
+
+private:
+    uint16_t data;
+};
+
+constexpr int MAX_MOVES = 256;
+
+// Fixed-capacity list of moves meant to live on the stack; no position has
+// more than 218 legal moves.
+class MoveList {
+public:
+    void Add(Move move) { moves[count++] = move; }
+    void Clear() { count = 0; }
+    int Size() const { return count; }
+    bool Empty() const { return count == 0; }
+    Move& operator[](int i) { return moves[i]; }
+    Move operator[](int i) const { return moves[i]; }
+    Move* begin() { return moves; }
+    Move* end() { return moves + count; }
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + count; }
+    bool Contains(Move move) const {
+        for (int i = 0; i < count; ++i) {
+            if (moves[i] == move) return true;
+        }
+        return false;
+    }
+
+private:
+    Move moves[MAX_MOVES];
+    int count = 0;
+};
+
+#endif // MOVE_H
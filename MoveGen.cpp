@@ -0,0 +1,250 @@
+#include "MoveGen.h"
+
+namespace {
+// Which part of the move list to produce. Promotions count as captures.
+enum class GenMode { ALL, CAPTURES, QUIETS };
+
+// Restrictions every generated move has to respect
+struct LegalityMask {
+    Square king;
+    Bitboard pinned;
+    Bitboard targets;   // destinations that resolve a check, or all non-own squares
+
+    bool Allows(Square from, Square to) const {
+        if (!(targets & SquareBB(to))) return false;
+        return !(pinned & SquareBB(from)) || (LineBB(king, from) & SquareBB(to));
+    }
+};
+
+void AddPawnMoves(Bitboard targets, int delta, uint16_t flags,
+                  const LegalityMask& mask, MoveList& list) {
+    while (targets) {
+        Square to = PopLsb(targets);
+        if (mask.Allows(to - delta, to)) {
+            list.Add(Move(to - delta, to, flags));
+        }
+    }
+}
+
+void AddPromotions(Bitboard targets, int delta, bool capture,
+                   const LegalityMask& mask, MoveList& list) {
+    while (targets) {
+        Square to = PopLsb(targets);
+        if (!mask.Allows(to - delta, to)) continue;
+        for (PieceType type : { PieceType::QUEEN, PieceType::KNIGHT, PieceType::ROOK, PieceType::BISHOP }) {
+            list.Add(Move::Promotion(to - delta, to, type, capture));
+        }
+    }
+}
+
+void GeneratePawnMoves(const Position& position, PieceColor us, GenMode mode, Bitboard fromMask,
+                       const LegalityMask& mask, MoveList& list) {
+    PieceColor them = Opponent(us);
+    bool white = (us == PieceColor::WHITE);
+    Bitboard pawns = position.Pieces(PieceType::PAWN, us) & fromMask;
+    Bitboard empty = ~position.Pieces();
+    Bitboard enemies = position.Pieces(them);
+    Bitboard promotionRank = white ? Rank8BB : Rank1BB;
+    Bitboard doublePushRank = white ? RankBB(3) : RankBB(4);
+    int up = white ? 8 : -8;
+
+    auto forward = [white](Bitboard b) { return white ? ShiftNorth(b) : ShiftSouth(b); };
+
+    Bitboard single = forward(pawns) & empty;
+    Bitboard twice = forward(single) & empty & doublePushRank;
+    if (mode != GenMode::CAPTURES) {
+        AddPawnMoves(single & ~promotionRank, up, QUIET, mask, list);
+        AddPawnMoves(twice, 2 * up, DOUBLE_PAWN_PUSH, mask, list);
+    }
+    if (mode == GenMode::QUIETS) return;
+
+    AddPromotions(single & promotionRank, up, false, mask, list);
+
+    Bitboard east = ShiftEast(forward(pawns)) & enemies;
+    Bitboard west = ShiftWest(forward(pawns)) & enemies;
+    AddPawnMoves(east & ~promotionRank, up + 1, CAPTURE, mask, list);
+    AddPawnMoves(west & ~promotionRank, up - 1, CAPTURE, mask, list);
+    AddPromotions(east & promotionRank, up + 1, true, mask, list);
+    AddPromotions(west & promotionRank, up - 1, true, mask, list);
+
+    // En passant removes two pawns from one rank at once, which can expose
+    // the king in ways the pin mask does not see, so test the resulting
+    // occupancy directly
+    Square ep = position.GetEnPassantTarget();
+    if (ep != NO_SQUARE) {
+        Square captured = ep - up;
+        Bitboard attackers = PawnAttacks(ep, them) & pawns;
+        while (attackers) {
+            Square from = PopLsb(attackers);
+            Bitboard occupied = (position.Pieces() ^ SquareBB(from) ^ SquareBB(captured)) | SquareBB(ep);
+            Bitboard checkers = position.AttackersTo(mask.king, occupied) & enemies & ~SquareBB(captured);
+            if (!checkers) {
+                list.Add(Move(from, ep, EN_PASSANT));
+            }
+        }
+    }
+}
+
+void AddPieceMoves(Square from, Bitboard targets, Bitboard enemies, MoveList& list) {
+    while (targets) {
+        Square to = PopLsb(targets);
+        list.Add(Move(from, to, (enemies & SquareBB(to)) ? CAPTURE : QUIET));
+    }
+}
+
+// Chosen at compile time, so each piece type gets its own inlined loop
+// instead of a switch on the type of every square
+template <PieceType Type>
+Bitboard PieceAttacks(Square from, Bitboard occupied) {
+    static_assert(Type == PieceType::KNIGHT || Type == PieceType::BISHOP ||
+                  Type == PieceType::ROOK || Type == PieceType::QUEEN, "no pawns or kings");
+    if constexpr (Type == PieceType::KNIGHT) return KnightAttacks(from);
+    else if constexpr (Type == PieceType::BISHOP) return BishopAttacks(from, occupied);
+    else if constexpr (Type == PieceType::ROOK) return RookAttacks(from, occupied);
+    else return QueenAttacks(from, occupied);
+}
+
+template <PieceType Type>
+void GeneratePieceMoves(const Position& position, PieceColor us, Bitboard fromMask, Bitboard allowed,
+                        const LegalityMask& mask, MoveList& list) {
+    Bitboard occupied = position.Pieces();
+    Bitboard enemies = position.Pieces(Opponent(us));
+    Bitboard pieces = position.Pieces(Type, us) & fromMask;
+    // A pinned knight can never move
+    if constexpr (Type == PieceType::KNIGHT) pieces &= ~mask.pinned;
+    while (pieces) {
+        Square from = PopLsb(pieces);
+        Bitboard targets = PieceAttacks<Type>(from, occupied) & mask.targets & allowed;
+        if (mask.pinned & SquareBB(from)) targets &= LineBB(mask.king, from);
+        AddPieceMoves(from, targets, enemies, list);
+    }
+}
+
+void GenerateCastling(const Position& position, PieceColor us, MoveList& list) {
+    Square king = position.GetKingSquare(us);
+    int y = (us == PieceColor::WHITE) ? 0 : 7;
+    if (king != MakeSquare(4, y)) return;
+
+    // The king may not pass through or land on an attacked square
+    PieceColor them = Opponent(us);
+    auto isSafe = [&](int x) { return !position.IsSquareUnderAttack(MakeSquare(x, y), them); };
+
+    if (position.CanCastleKingside(us) &&
+        (position.Pieces(PieceType::ROOK, us) & SquareBB(MakeSquare(7, y))) &&
+        !(BetweenBB(king, MakeSquare(7, y)) & position.Pieces()) &&
+        isSafe(5) && isSafe(6)) {
+        list.Add(Move(king, MakeSquare(6, y), KING_CASTLE));
+    }
+    if (position.CanCastleQueenside(us) &&
+        (position.Pieces(PieceType::ROOK, us) & SquareBB(MakeSquare(0, y))) &&
+        !(BetweenBB(king, MakeSquare(0, y)) & position.Pieces()) &&
+        isSafe(3) && isSafe(2)) {
+        list.Add(Move(king, MakeSquare(2, y), QUEEN_CASTLE));
+    }
+}
+
+// Generates the legal moves of the pieces on 'fromMask' selected by 'mode'
+void Generate(const Position& position, GenMode mode, Bitboard fromMask, MoveList& list) {
+    PieceColor us = position.GetSideToMove();
+    Square king = position.GetKingSquare(us);
+    Bitboard ours = position.Pieces(us);
+    Bitboard enemies = position.Pieces(Opponent(us));
+    Bitboard checkers = position.Checkers();
+    Bitboard allowed = (mode == GenMode::CAPTURES) ? enemies
+                     : (mode == GenMode::QUIETS) ? ~position.Pieces() : ~ours;
+
+    // The king may go to any square that is not attacked once it has left
+    // its current one (so it cannot step back along a checking ray)
+    Bitboard kingTargets = (fromMask & SquareBB(king)) ? KingAttacks(king) & allowed : 0;
+    Bitboard withoutKing = position.Pieces() ^ SquareBB(king);
+    while (kingTargets) {
+        Square to = PopLsb(kingTargets);
+        if (!(position.AttackersTo(to, withoutKing) & enemies)) {
+            list.Add(Move(king, to, (enemies & SquareBB(to)) ? CAPTURE : QUIET));
+        }
+    }
+
+    // In double check only the king can move
+    if (MoreThanOne(checkers)) return;
+
+    LegalityMask mask;
+    mask.king = king;
+    mask.pinned = position.PinnedPieces(us);
+    mask.targets = checkers ? (BetweenBB(king, Lsb(checkers)) | checkers) : ~ours;
+
+    GeneratePawnMoves(position, us, mode, fromMask, mask, list);
+
+    GeneratePieceMoves<PieceType::KNIGHT>(position, us, fromMask, allowed, mask, list);
+    GeneratePieceMoves<PieceType::BISHOP>(position, us, fromMask, allowed, mask, list);
+    GeneratePieceMoves<PieceType::ROOK>(position, us, fromMask, allowed, mask, list);
+    GeneratePieceMoves<PieceType::QUEEN>(position, us, fromMask, allowed, mask, list);
+
+    if (!checkers && mode != GenMode::CAPTURES && (fromMask & SquareBB(king))) {
+        GenerateCastling(position, us, list);
+    }
+}
+}
+
+void GenerateLegalMoves(const Position& position, MoveList& list) {
+    Generate(position, GenMode::ALL, ~0ULL, list);
+}
+
+void GenerateLegalCaptures(const Position& position, MoveList& list) {
+    Generate(position, GenMode::CAPTURES, ~0ULL, list);
+}
+
+void GenerateLegalQuiets(const Position& position, MoveList& list) {
+    Generate(position, GenMode::QUIETS, ~0ULL, list);
+}
+
+void GenerateLegalMovesFrom(const Position& position, Square from, MoveList& list) {
+    Generate(position, GenMode::ALL, SquareBB(from), list);
+}
+
+bool IsLegalMove(const Position& position, Move move) {
+    PieceColor us = position.GetSideToMove();
+    PieceColor them = Opponent(us);
+    Square from = move.From();
+    Square to = move.To();
+    if (move.IsNone() || position.GetPieceColor(from) != us) return false;
+
+    // Castling and en passant are rare enough to leave to the generator
+    if (move.IsCastle() || move.IsEnPassant()) {
+        MoveList moves;
+        Generate(position, move.IsCastle() ? GenMode::QUIETS : GenMode::CAPTURES, SquareBB(from), moves);
+        return moves.Contains(move);
+    }
+
+    // The flags have to describe what is on the board
+    uint16_t flags = move.Flags();
+    if (flags == 6 || flags == 7) return false;
+    if (move.IsCapture() ? position.GetPieceColor(to) != them : !position.IsEmpty(to)) return false;
+
+    PieceType type = position.GetPieceType(from);
+    if (type == PieceType::PAWN) {
+        bool white = (us == PieceColor::WHITE);
+        int up = white ? 8 : -8;
+        bool lastRank = RankOf(to) == (white ? 7 : 0);
+        if (move.IsPromotion() != lastRank) return false;
+        if (move.IsCapture()) {
+            if (!(PawnAttacks(from, us) & SquareBB(to))) return false;
+        } else if (flags == DOUBLE_PAWN_PUSH) {
+            if (RankOf(from) != (white ? 1 : 6) || to != from + 2 * up || !position.IsEmpty(from + up)) return false;
+        } else if (to != from + up) {
+            return false;
+        }
+    } else {
+        if (move.IsPromotion() || flags == DOUBLE_PAWN_PUSH) return false;
+        if (!(position.GetAttacks(from) & SquareBB(to))) return false;
+    }
+
+    // Legal if no enemy piece, other than one captured on 'to', attacks the
+    // king afterwards. This covers pins and check evasions alike.
+    Bitboard occupied = position.Pieces() ^ SquareBB(from);
+    if (type == PieceType::KING) {
+        return !(position.AttackersTo(to, occupied) & position.Pieces(them));
+    }
+    Square king = position.GetKingSquare(us);
+    Bitboard attackers = position.AttackersTo(king, occupied | SquareBB(to)) & position.Pieces(them);
+    return !(attackers & ~SquareBB(to));
+}
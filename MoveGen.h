@@ -0,0 +1,22 @@
+#ifndef MOVEGEN_H
+#define MOVEGEN_H
+
+#include "Move.h"
+#include "Position.h"
+
+// Appends every legal move of the side to move to 'list'. Checkers and
+// pinned pieces are computed once up front, so no move has to be tried on
+// the board to know it is legal.
+void GenerateLegalMoves(const Position& position, MoveList& list);
+// Only the legal captures (en passant included) and promotions, for the
+// quiescence search
+void GenerateLegalCaptures(const Position& position, MoveList& list);
+// The remaining legal moves: quiet moves and castling
+void GenerateLegalQuiets(const Position& position, MoveList& list);
+// The legal moves of the piece on 'from' only
+void GenerateLegalMovesFrom(const Position& position, Square from, MoveList& list);
+// Whether a move from elsewhere (hash table, killer slot) is legal here.
+// Tests the one move directly; only castling and en passant generate.
+bool IsLegalMove(const Position& position, Move move);
+
+#endif // MOVEGEN_H
@@ -0,0 +1,120 @@
+#include "MovePicker.h"
+#include "MoveGen.h"
+#include <utility>
+
+int CaptureScore(const Position& position, Move move) {
+    PieceType victim = move.IsEnPassant() ? PieceType::PAWN : position.GetPieceType(move.To());
+    int score = PieceValue(victim) * 16 - PieceValue(position.GetPieceType(move.From())) / 16;
+    if (move.IsPromotion()) score += PieceValue(move.PromotionType()) * 16;
+    return score;
+}
+
+MovePicker::MovePicker(const Position& position, Move ttMove, const Move* killers,
+                       Move counterMove, const HistoryTable& history)
+    : position(position), history(history), counterMove(counterMove) {
+    // Moves from the table or another node are only hints and may not even
+    // be legal here
+    this->ttMove = IsLegalMove(position, ttMove) ? ttMove : Move::None();
+    this->killers[0] = killers[0];
+    this->killers[1] = killers[1];
+}
+
+bool MovePicker::IsRefutation(Move move) const {
+    return move == killers[0] || move == killers[1] || move == counterMove;
+}
+
+bool MovePicker::IsUsableQuiet(Move move) const {
+    return !move.IsNone() && move != ttMove && !move.IsCapture() && !move.IsPromotion()
+        && IsLegalMove(position, move);
+}
+
+// Selection sort step: moves the best remaining move to 'current'
+Move MovePicker::PickBest() {
+    int best = current;
+    for (int i = current + 1; i < moves.Size(); ++i) {
+        if (scores[i] > scores[best]) best = i;
+    }
+    std::swap(moves[current], moves[best]);
+    std::swap(scores[current], scores[best]);
+    return moves[current++];
+}
+
+Move MovePicker::Next() {
+    while (true) {
+        switch (stage) {
+        case Stage::TT_MOVE:
+            stage = Stage::GEN_CAPTURES;
+            if (!ttMove.IsNone()) return ttMove;
+            break;
+
+        case Stage::GEN_CAPTURES:
+            GenerateLegalCaptures(position, moves);
+            for (int i = 0; i < moves.Size(); ++i) {
+                scores[i] = CaptureScore(position, moves[i]);
+            }
+            current = 0;
+            stage = Stage::GOOD_CAPTURES;
+            break;
+
+        case Stage::GOOD_CAPTURES:
+            while (current < moves.Size()) {
+                Move move = PickBest();
+                if (move == ttMove) continue;
+                // Losing captures and underpromotions wait until the end
+                bool underpromotion = move.IsPromotion() && move.PromotionType() != PieceType::QUEEN;
+                if (underpromotion || position.See(move) < 0) {
+                    badCaptures.Add(move);
+                    continue;
+                }
+                return move;
+            }
+            stage = Stage::KILLER_1;
+            break;
+
+        case Stage::KILLER_1:
+            stage = Stage::KILLER_2;
+            if (IsUsableQuiet(killers[0])) return killers[0];
+            break;
+
+        case Stage::KILLER_2:
+            stage = Stage::COUNTER_MOVE;
+            if (killers[1] != killers[0] && IsUsableQuiet(killers[1])) return killers[1];
+            break;
+
+        case Stage::COUNTER_MOVE:
+            stage = Stage::GEN_QUIETS;
+            if (counterMove != killers[0] && counterMove != killers[1] && IsUsableQuiet(counterMove)) {
+                return counterMove;
+            }
+            break;
+
+        case Stage::GEN_QUIETS: {
+            moves.Clear();
+            GenerateLegalQuiets(position, moves);
+            int color = int(position.GetSideToMove());
+            for (int i = 0; i < moves.Size(); ++i) {
+                scores[i] = history[color][moves[i].From()][moves[i].To()];
+            }
+            current = 0;
+            stage = Stage::QUIETS;
+            break;
+        }
+
+        case Stage::QUIETS:
+            while (current < moves.Size()) {
+                Move move = PickBest();
+                if (move != ttMove && !IsRefutation(move)) return move;
+            }
+            stage = Stage::BAD_CAPTURES;
+            break;
+
+        case Stage::BAD_CAPTURES:
+            if (badCurrent < badCaptures.Size()) return badCaptures[badCurrent++];
+            stage = Stage::DONE;
+            break;
+
+        case Stage::DONE:
+            return Move::None();
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef MOVEPICKER_H
+#define MOVEPICKER_H
+
+#include "Move.h"
+#include "Position.h"
+
+// Butterfly history: credit earned by quiet moves that caused a cutoff,
+// indexed by color, from and to square.
+using HistoryTable = int[3][64][64];
+
+// Most valuable victim first, cheapest attacker first among equals.
+int CaptureScore(const Position& position, Move move);
+
+// Hands out the legal moves of a position one at a time, in stages, and
+// generates each group only once the previous one is used up:
+//   hash move, captures that do not lose material (MVV-LVA), the two
+//   killers, the counter move, quiet moves by history, losing captures.
+// A cutoff on the hash move therefore costs no move generation at all: the
+// hash, killer and counter moves are validated by IsLegalMove, which tests
+// the single move against the board without generating.
+class MovePicker {
+public:
+    MovePicker(const Position& position, Move ttMove, const Move* killers,
+               Move counterMove, const HistoryTable& history);
+
+    // Returns Move::None() once every move has been handed out
+    Move Next();
+
+private:
+    enum class Stage {
+        TT_MOVE, GEN_CAPTURES, GOOD_CAPTURES, KILLER_1, KILLER_2, COUNTER_MOVE,
+        GEN_QUIETS, QUIETS, BAD_CAPTURES, DONE
+    };
+
+    Move PickBest();
+    bool IsRefutation(Move move) const;
+    bool IsUsableQuiet(Move move) const;
+
+    const Position& position;
+    const HistoryTable& history;
+    Stage stage = Stage::TT_MOVE;
+    Move ttMove;
+    Move killers[2];
+    Move counterMove;
+
+    MoveList moves;
+    int scores[MAX_MOVES];
+    int current = 0;
+    MoveList badCaptures;
+    int badCurrent = 0;
+};
+
+#endif // MOVEPICKER_H
@@ -0,0 +1,350 @@
+#include "Nnue.h"
+#include "Prng.h"
+#include <cstring>
+#include <fstream>
+
+#if defined(__x86_64__)
+#define HAS_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace {
+// Accumulator values are clipped to [0, QA] before the output layer, whose
+// weights are scaled by QB; OUTPUT_SCALE turns the result into centipawns
+constexpr int QA = 255;
+constexpr int QB = 64;
+constexpr int OUTPUT_SCALE = 400;
+
+constexpr char FILE_MAGIC[4] = { 'M', 'M', 'N', 'N' };
+constexpr uint32_t FILE_VERSION = 1;
+
+PieceColor PerspectiveColor(int perspective) {
+    return perspective == 0 ? PieceColor::WHITE : PieceColor::BLACK;
+}
+
+int FeatureIndex(int perspective, Square kingSquare, PieceType type, PieceColor color, Square s) {
+    // Black sees the board upside down
+    int flip = (perspective == 0) ? 0 : 56;
+    int piece = (int(type) - int(PieceType::PAWN)) * 2 + (color == PerspectiveColor(perspective) ? 0 : 1);
+    return ((kingSquare ^ flip) * 10 + piece) * 64 + (s ^ flip);
+}
+
+// Kernels: add or subtract one weight row to an accumulator, and the
+// output layer over both accumulators
+struct Kernels {
+    void (*addRow)(int16_t* accumulator, const int16_t* row);
+    void (*subRow)(int16_t* accumulator, const int16_t* row);
+    int32_t (*output)(const int16_t* us, const int16_t* them, const int16_t* weights);
+};
+
+void AddRowScalar(int16_t* accumulator, const int16_t* row) {
+    for (int i = 0; i < NNUE_HIDDEN; ++i) accumulator[i] += row[i];
+}
+
+void SubRowScalar(int16_t* accumulator, const int16_t* row) {
+    for (int i = 0; i < NNUE_HIDDEN; ++i) accumulator[i] -= row[i];
+}
+
+int32_t OutputScalar(const int16_t* us, const int16_t* them, const int16_t* weights) {
+    int32_t sum = 0;
+    for (int i = 0; i < NNUE_HIDDEN; ++i) {
+        int v = us[i] < 0 ? 0 : us[i] > QA ? QA : us[i];
+        sum += v * weights[i];
+    }
+    for (int i = 0; i < NNUE_HIDDEN; ++i) {
+        int v = them[i] < 0 ? 0 : them[i] > QA ? QA : them[i];
+        sum += v * weights[NNUE_HIDDEN + i];
+    }
+    return sum;
+}
+
+#if defined(HAS_X86_SIMD)
+// Compiled for the instruction set in the target attribute regardless of
+// the build flags; only called after the CPU has reported support for it
+
+__attribute__((target("sse4.1")))
+void AddRowSse41(int16_t* accumulator, const int16_t* row) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(accumulator + i));
+        __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        _mm_store_si128(reinterpret_cast<__m128i*>(accumulator + i), _mm_add_epi16(a, r));
+    }
+}
+
+__attribute__((target("sse4.1")))
+void SubRowSse41(int16_t* accumulator, const int16_t* row) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(accumulator + i));
+        __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        _mm_store_si128(reinterpret_cast<__m128i*>(accumulator + i), _mm_sub_epi16(a, r));
+    }
+}
+
+__attribute__((target("sse4.1")))
+int32_t OutputSse41(const int16_t* us, const int16_t* them, const int16_t* weights) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i qa = _mm_set1_epi16(QA);
+    __m128i sum = _mm_setzero_si128();
+    const int16_t* inputs[2] = { us, them };
+    for (int side = 0; side < 2; ++side) {
+        for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+            __m128i v = _mm_load_si128(reinterpret_cast<const __m128i*>(inputs[side] + i));
+            v = _mm_min_epi16(_mm_max_epi16(v, zero), qa);
+            __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + side * NNUE_HIDDEN + i));
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(v, w));
+        }
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+}
+
+__attribute__((target("avx2")))
+void AddRowAvx2(int16_t* accumulator, const int16_t* row) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(accumulator + i));
+        __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(accumulator + i), _mm256_add_epi16(a, r));
+    }
+}
+
+__attribute__((target("avx2")))
+void SubRowAvx2(int16_t* accumulator, const int16_t* row) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(accumulator + i));
+        __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(accumulator + i), _mm256_sub_epi16(a, r));
+    }
+}
+
+__attribute__((target("avx2")))
+int32_t OutputAvx2(const int16_t* us, const int16_t* them, const int16_t* weights) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i qa = _mm256_set1_epi16(QA);
+    __m256i sum = _mm256_setzero_si256();
+    const int16_t* inputs[2] = { us, them };
+    for (int side = 0; side < 2; ++side) {
+        for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+            __m256i v = _mm256_load_si256(reinterpret_cast<const __m256i*>(inputs[side] + i));
+            v = _mm256_min_epi16(_mm256_max_epi16(v, zero), qa);
+            __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + side * NNUE_HIDDEN + i));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(v, w));
+        }
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+    return _mm_cvtsi128_si32(half);
+}
+#endif
+
+const Kernels SCALAR_KERNELS = { AddRowScalar, SubRowScalar, OutputScalar };
+#if defined(HAS_X86_SIMD)
+const Kernels SSE41_KERNELS = { AddRowSse41, SubRowSse41, OutputSse41 };
+const Kernels AVX2_KERNELS = { AddRowAvx2, SubRowAvx2, OutputAvx2 };
+#endif
+
+SimdLevel simdLevel = SimdLevel::SCALAR;
+const Kernels* kernels = &SCALAR_KERNELS;
+
+struct KernelSelector {
+    KernelSelector() { SetSimdLevel(DetectSimdLevel()); }
+};
+const KernelSelector kKernelSelector;
+}
+
+SimdLevel DetectSimdLevel() {
+#if defined(HAS_X86_SIMD)
+    // May run from a static initializer, before the CPU model is filled in
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return SimdLevel::SSE41;
+#endif
+    return SimdLevel::SCALAR;
+}
+
+SimdLevel GetSimdLevel() {
+    return simdLevel;
+}
+
+void SetSimdLevel(SimdLevel level) {
+    if (int(level) > int(DetectSimdLevel())) level = DetectSimdLevel();
+    simdLevel = level;
+    kernels = &SCALAR_KERNELS;
+#if defined(HAS_X86_SIMD)
+    if (level == SimdLevel::SSE41) kernels = &SSE41_KERNELS;
+    if (level == SimdLevel::AVX2) kernels = &AVX2_KERNELS;
+#endif
+}
+
+const char* SimdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::AVX2: return "avx2";
+    case SimdLevel::SSE41: return "sse4.1";
+    default: return "scalar";
+    }
+}
+
+Network::Network()
+    : featureWeights(new int16_t[size_t(NNUE_INPUTS) * NNUE_HIDDEN]()),
+      featureBias(new int16_t[NNUE_HIDDEN]()),
+      outputWeights(new int16_t[2 * NNUE_HIDDEN]()) {}
+
+// File layout, little endian: magic "MMNN", version, input count, hidden
+// size (uint32 each), then the feature weights, feature bias and output
+// weights as int16 and the output bias as int32.
+bool Network::Load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[4];
+    uint32_t header[3];
+    if (!in.read(magic, sizeof(magic)) || !in.read(reinterpret_cast<char*>(header), sizeof(header))) return false;
+    if (std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0 || header[0] != FILE_VERSION ||
+        header[1] != uint32_t(NNUE_INPUTS) || header[2] != uint32_t(NNUE_HIDDEN)) {
+        return false;
+    }
+
+    Network loaded;
+    in.read(reinterpret_cast<char*>(loaded.featureWeights.get()), sizeof(int16_t) * NNUE_INPUTS * NNUE_HIDDEN);
+    in.read(reinterpret_cast<char*>(loaded.featureBias.get()), sizeof(int16_t) * NNUE_HIDDEN);
+    in.read(reinterpret_cast<char*>(loaded.outputWeights.get()), sizeof(int16_t) * 2 * NNUE_HIDDEN);
+    in.read(reinterpret_cast<char*>(&loaded.outputBias), sizeof(int32_t));
+    // Truncated, or followed by data that belongs to some other format
+    if (!in || in.peek() != std::ifstream::traits_type::eof()) return false;
+
+    *this = std::move(loaded);
+    return true;
+}
+
+bool Network::Save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    const uint32_t header[3] = { FILE_VERSION, uint32_t(NNUE_INPUTS), uint32_t(NNUE_HIDDEN) };
+    out.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(featureWeights.get()), sizeof(int16_t) * NNUE_INPUTS * NNUE_HIDDEN);
+    out.write(reinterpret_cast<const char*>(featureBias.get()), sizeof(int16_t) * NNUE_HIDDEN);
+    out.write(reinterpret_cast<const char*>(outputWeights.get()), sizeof(int16_t) * 2 * NNUE_HIDDEN);
+    out.write(reinterpret_cast<const char*>(&outputBias), sizeof(int32_t));
+    return bool(out);
+}
+
+void Network::InitRandom(uint64_t seed) {
+    Prng prng(seed);
+    auto random = [&prng](int range) { return int16_t(int(prng.Next() % (2 * range + 1)) - range); };
+    for (size_t i = 0; i < size_t(NNUE_INPUTS) * NNUE_HIDDEN; ++i) featureWeights[i] = random(16);
+    for (int i = 0; i < NNUE_HIDDEN; ++i) featureBias[i] = random(64);
+    for (int i = 0; i < 2 * NNUE_HIDDEN; ++i) outputWeights[i] = random(64);
+    outputBias = 0;
+}
+
+void AccumulatorStack::Reset(const Position& position, const Network& network) {
+    top = 0;
+    stack[0].kingMoved[0] = stack[0].kingMoved[1] = false;
+    stack[0].dirtyCount = 0;
+    for (int perspective = 0; perspective < 2; ++perspective) {
+        Refresh(stack[0], perspective, position, network);
+    }
+}
+
+void AccumulatorStack::Refresh(Accumulator& accumulator, int perspective, const Position& position,
+                               const Network& network) {
+    int16_t* values = accumulator.values[perspective];
+    std::memcpy(values, network.featureBias.get(), sizeof(int16_t) * NNUE_HIDDEN);
+
+    Square kingSquare = position.GetKingSquare(PerspectiveColor(perspective));
+    Bitboard pieces = position.Pieces() & ~position.Pieces(PieceType::KING);
+    while (pieces) {
+        Square s = PopLsb(pieces);
+        int feature = FeatureIndex(perspective, kingSquare, position.GetPieceType(s), position.GetPieceColor(s), s);
+        kernels->addRow(values, &network.featureWeights[size_t(feature) * NNUE_HIDDEN]);
+    }
+    accumulator.computed[perspective] = true;
+}
+
+void AccumulatorStack::Update(int index, int perspective, Square kingSquare, const Network& network) {
+    Accumulator& accumulator = stack[index];
+    int16_t* values = accumulator.values[perspective];
+    std::memcpy(values, stack[index - 1].values[perspective], sizeof(int16_t) * NNUE_HIDDEN);
+
+    for (int i = 0; i < accumulator.dirtyCount; ++i) {
+        const DirtyPiece& piece = accumulator.dirty[i];
+        if (piece.from != NO_SQUARE) {
+            int feature = FeatureIndex(perspective, kingSquare, piece.type, piece.color, piece.from);
+            kernels->subRow(values, &network.featureWeights[size_t(feature) * NNUE_HIDDEN]);
+        }
+        if (piece.to != NO_SQUARE) {
+            int feature = FeatureIndex(perspective, kingSquare, piece.type, piece.color, piece.to);
+            kernels->addRow(values, &network.featureWeights[size_t(feature) * NNUE_HIDDEN]);
+        }
+    }
+    accumulator.computed[perspective] = true;
+}
+
+void AccumulatorStack::Push(const Position& position, Move move) {
+    Accumulator& next = stack[top + 1];
+    next.computed[0] = next.computed[1] = false;
+    next.kingMoved[0] = next.kingMoved[1] = false;
+    next.dirtyCount = 0;
+
+    Square from = move.From();
+    Square to = move.To();
+    PieceType type = position.GetPieceType(from);
+    PieceColor color = position.GetPieceColor(from);
+    PieceColor enemy = Opponent(color);
+
+    // Kings are not inputs; moving one changes every feature of its side
+    if (type == PieceType::KING) {
+        next.kingMoved[color == PieceColor::WHITE ? 0 : 1] = true;
+    } else if (move.IsPromotion()) {
+        next.dirty[next.dirtyCount++] = { PieceType::PAWN, color, from, NO_SQUARE };
+        next.dirty[next.dirtyCount++] = { move.PromotionType(), color, NO_SQUARE, to };
+    } else {
+        next.dirty[next.dirtyCount++] = { type, color, from, to };
+    }
+
+    if (move.IsEnPassant()) {
+        Square captured = (color == PieceColor::WHITE) ? to - 8 : to + 8;
+        next.dirty[next.dirtyCount++] = { PieceType::PAWN, enemy, captured, NO_SQUARE };
+    } else if (move.IsCapture()) {
+        next.dirty[next.dirtyCount++] = { position.GetPieceType(to), enemy, to, NO_SQUARE };
+    }
+
+    if (move.Flags() == KING_CASTLE) {
+        next.dirty[next.dirtyCount++] = { PieceType::ROOK, color, to + 1, to - 1 };
+    } else if (move.Flags() == QUEEN_CASTLE) {
+        next.dirty[next.dirtyCount++] = { PieceType::ROOK, color, to - 2, to + 1 };
+    }
+    ++top;
+}
+
+void AccumulatorStack::PushNull() {
+    Accumulator& next = stack[top + 1];
+    next.computed[0] = next.computed[1] = false;
+    next.kingMoved[0] = next.kingMoved[1] = false;
+    next.dirtyCount = 0;
+    ++top;
+}
+
+int AccumulatorStack::Evaluate(const Position& position, const Network& network) {
+    for (int perspective = 0; perspective < 2; ++perspective) {
+        if (stack[top].computed[perspective]) continue;
+
+        // Walk back to the last computed accumulator; if this side's king
+        // moved on the way there, recomputing from scratch is cheaper
+        int last = top;
+        while (!stack[last].computed[perspective] && !stack[last].kingMoved[perspective]) --last;
+        if (!stack[last].computed[perspective]) {
+            Refresh(stack[top], perspective, position, network);
+            continue;
+        }
+
+        Square kingSquare = position.GetKingSquare(PerspectiveColor(perspective));
+        for (int i = last + 1; i <= top; ++i) {
+            Update(i, perspective, kingSquare, network);
+        }
+    }
+
+    int us = (position.GetSideToMove() == PieceColor::WHITE) ? 0 : 1;
+    const Accumulator& current = stack[top];
+    int32_t output = kernels->output(current.values[us], current.values[1 - us], network.outputWeights.get());
+    return int((int64_t(output) + network.outputBias) * OUTPUT_SCALE / (QA * QB));
+}
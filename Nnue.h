@@ -0,0 +1,93 @@
+#ifndef NNUE_H
+#define NNUE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "Move.h"
+#include "Position.h"
+
+// Efficiently updatable neural network evaluation (NNUE).
+//
+// Input layer, HalfKP style: for each side's perspective one feature per
+// (own king square, non-king piece, square), with the board mirrored
+// vertically for Black so both perspectives share one set of weights. The
+// 128-wide hidden layer ("accumulator") is the sum of the active features'
+// weight rows, so a move only adds and subtracts the few rows of the
+// pieces it moved. The output is a clipped-ReLU dot product of the side to
+// move's and the other side's accumulators.
+constexpr int NNUE_INPUTS = 64 * 10 * 64;
+constexpr int NNUE_HIDDEN = 128;
+
+// Vector kernels, chosen at startup from what the CPU supports
+enum class SimdLevel { SCALAR, SSE41, AVX2 };
+
+SimdLevel DetectSimdLevel();
+SimdLevel GetSimdLevel();
+// Selects a kernel set no wider than the CPU supports, e.g. for benchmarks
+void SetSimdLevel(SimdLevel level);
+const char* SimdLevelName(SimdLevel level);
+
+class Network {
+public:
+    Network();
+
+    // Reads weights from a file in the format written by Save; returns
+    // false (keeping the current weights) if it is missing or malformed
+    bool Load(const std::string& path);
+    bool Save(const std::string& path) const;
+    // Small random weights, only useful to measure speed
+    void InitRandom(uint64_t seed);
+
+private:
+    friend class AccumulatorStack;
+
+    std::unique_ptr<int16_t[]> featureWeights;  // [NNUE_INPUTS][NNUE_HIDDEN]
+    std::unique_ptr<int16_t[]> featureBias;     // [NNUE_HIDDEN]
+    std::unique_ptr<int16_t[]> outputWeights;   // [2][NNUE_HIDDEN], side to move first
+    int32_t outputBias = 0;
+};
+
+// Accumulators of the positions along the current search line, one per
+// ply. Push records which pieces a move changes without computing
+// anything; the accumulators are brought up to date only when a position
+// is evaluated, from the nearest computed ply below. Pop is free.
+class AccumulatorStack {
+public:
+    // Computes the root's accumulators from scratch and empties the stack
+    void Reset(const Position& position, const Network& network);
+    // Before position.MakeMove(move)
+    void Push(const Position& position, Move move);
+    void PushNull();
+    void Pop() { --top; }
+
+    // Score in centipawns for the side to move
+    int Evaluate(const Position& position, const Network& network);
+
+    static constexpr int MAX_DEPTH = 256;
+
+private:
+    // A piece leaving 'from' and/or arriving on 'to' (NO_SQUARE if not)
+    struct DirtyPiece {
+        PieceType type;
+        PieceColor color;
+        Square from;
+        Square to;
+    };
+
+    struct Accumulator {
+        alignas(32) int16_t values[2][NNUE_HIDDEN];
+        bool computed[2];
+        bool kingMoved[2];
+        DirtyPiece dirty[3];
+        int dirtyCount;
+    };
+
+    void Refresh(Accumulator& accumulator, int perspective, const Position& position, const Network& network);
+    void Update(int index, int perspective, Square kingSquare, const Network& network);
+
+    std::unique_ptr<Accumulator[]> stack{new Accumulator[MAX_DEPTH]};
+    int top = 0;
+};
+
+#endif // NNUE_H
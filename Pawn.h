@@ -10,13 +10,6 @@ public:
     Pawn(PieceColor color);
     wxString GetSymbol() const override;
     std::string GetName() const override;
-    std::vector<wxPoint> GetPossibleMoves(const Board& board, wxPoint position) const override;
-    
-    void SetMoved(bool moved) { hasMoved = moved; }
-    bool HasMoved() const { return hasMoved; }
-
-private:
-    bool hasMoved = false;
 };
 
 #endif
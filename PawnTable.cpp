@@ -0,0 +1,112 @@
+#include "PawnTable.h"
+
+namespace {
+constexpr int DOUBLED_MIDGAME = -10;
+constexpr int DOUBLED_ENDGAME = -20;
+constexpr int ISOLATED_MIDGAME = -15;
+constexpr int ISOLATED_ENDGAME = -10;
+// By rank counted from the pawn's own side
+constexpr int PASSED_MIDGAME[8] = { 0, 5, 10, 15, 25, 40, 60, 0 };
+constexpr int PASSED_ENDGAME[8] = { 0, 10, 15, 25, 45, 70, 110, 0 };
+
+Bitboard NorthFill(Bitboard b) {
+    b |= b << 8;
+    b |= b << 16;
+    b |= b << 32;
+    return b;
+}
+
+Bitboard SouthFill(Bitboard b) {
+    b |= b >> 8;
+    b |= b >> 16;
+    b |= b >> 32;
+    return b;
+}
+
+// Bit f set when the file f holds at least one of the pawns
+uint8_t OccupiedFiles(Bitboard pawns) {
+    return uint8_t(SouthFill(pawns) & Rank1BB);
+}
+
+// Squares the pawns still pass or attack on their way to promotion
+Bitboard FrontSpan(Bitboard pawns, PieceColor color) {
+    Bitboard front = (color == PieceColor::WHITE) ? NorthFill(ShiftNorth(pawns))
+                                                  : SouthFill(ShiftSouth(pawns));
+    return front | ShiftEast(front) | ShiftWest(front);
+}
+
+void EvaluateSide(const Position& position, PieceColor color, PawnEntry& entry) {
+    Bitboard ours = position.Pieces(PieceType::PAWN, color);
+    Bitboard theirs = position.Pieces(PieceType::PAWN, Opponent(color));
+    uint8_t ourFiles = OccupiedFiles(ours);
+
+    // Only the frontmost of doubled pawns can be passed
+    Bitboard behindOwn = (color == PieceColor::WHITE) ? SouthFill(ShiftSouth(ours))
+                                                      : NorthFill(ShiftNorth(ours));
+    Bitboard passed = ours & ~FrontSpan(theirs, Opponent(color)) & ~behindOwn;
+
+    int midgame = 0;
+    int endgame = 0;
+    for (int file = 0; file < 8; ++file) {
+        int count = PopCount(ours & FileBB(file));
+        if (count > 1) {
+            midgame += DOUBLED_MIDGAME * (count - 1);
+            endgame += DOUBLED_ENDGAME * (count - 1);
+        }
+    }
+
+    Bitboard pawns = ours;
+    while (pawns) {
+        Square s = PopLsb(pawns);
+        int file = FileOf(s);
+        uint8_t neighbours = uint8_t(((1 << file) << 1) | ((1 << file) >> 1));
+        if (!(ourFiles & neighbours)) {
+            midgame += ISOLATED_MIDGAME;
+            endgame += ISOLATED_ENDGAME;
+        }
+        if (passed & SquareBB(s)) {
+            int rank = (color == PieceColor::WHITE) ? RankOf(s) : 7 - RankOf(s);
+            midgame += PASSED_MIDGAME[rank];
+            endgame += PASSED_ENDGAME[rank];
+        }
+    }
+
+    int sign = (color == PieceColor::WHITE) ? 1 : -1;
+    entry.midgame += sign * midgame;
+    entry.endgame += sign * endgame;
+    entry.passedPawns[int(color)] = passed;
+    entry.semiOpenFiles[int(color)] = uint8_t(~ourFiles);
+}
+}
+
+void EvaluatePawns(const Position& position, PawnEntry& entry) {
+    entry.key = position.GetPawnKey();
+    entry.midgame = 0;
+    entry.endgame = 0;
+    entry.passedPawns[int(PieceColor::NONE)] = 0;
+    entry.semiOpenFiles[int(PieceColor::NONE)] = 0;
+    EvaluateSide(position, PieceColor::WHITE, entry);
+    EvaluateSide(position, PieceColor::BLACK, entry);
+    entry.openFiles = entry.semiOpenFiles[int(PieceColor::WHITE)] &
+                      entry.semiOpenFiles[int(PieceColor::BLACK)];
+}
+
+PawnTable::PawnTable(size_t entryCount) {
+    size_t count = 1;
+    while (count * 2 <= entryCount) count *= 2;
+    entries.resize(count);
+    mask = count - 1;
+    Clear();
+}
+
+void PawnTable::Clear() {
+    // No pawn structure has this key in practice, so every slot misses
+    for (PawnEntry& entry : entries) entry = PawnEntry{ ~0ULL, 0, 0, {}, {}, 0 };
+}
+
+const PawnEntry& PawnTable::Probe(const Position& position) {
+    uint64_t key = position.GetPawnKey();
+    PawnEntry& entry = entries[key & mask];
+    if (entry.key != key) EvaluatePawns(position, entry);
+    return entry;
+}
@@ -0,0 +1,43 @@
+#ifndef PAWNTABLE_H
+#define PAWNTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Bitboard.h"
+#include "Position.h"
+
+// Pawn structure evaluation of one pawn configuration, and what the rest of
+// the evaluation wants to know about it. Scores are from White's point of
+// view; the per-side arrays are indexed by PieceColor.
+struct PawnEntry {
+    uint64_t key;
+    int midgame;
+    int endgame;
+    Bitboard passedPawns[3];
+    // One bit per file: no pawn of that side, no pawn at all
+    uint8_t semiOpenFiles[3];
+    uint8_t openFiles;
+};
+
+// Cache of pawn structure evaluations indexed by the position's pawn key.
+// Pawns move in only a small fraction of moves, so nearly every probe hits.
+// Not thread safe; every search thread has its own.
+class PawnTable {
+public:
+    // The size is rounded down to a power of two
+    explicit PawnTable(size_t entryCount = 16384);
+
+    void Clear();
+    // The entry for the position's pawns, evaluated now if it is not cached
+    const PawnEntry& Probe(const Position& position);
+
+private:
+    std::vector<PawnEntry> entries;
+    size_t mask = 0;
+};
+
+// Doubled, isolated and passed pawns of both sides, from scratch
+void EvaluatePawns(const Position& position, PawnEntry& entry);
+
+#endif // PAWNTABLE_H
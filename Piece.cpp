@@ -0,0 +1,6 @@
+#include "Piece.h"
+#include "Board.h"
+
+std::vector<wxPoint> Piece::GetPossibleMoves(const Board& board, wxPoint position) const {
+    return board.GetLegalMoves(position);
+}
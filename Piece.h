@@ -3,12 +3,10 @@
 
 #include <wx/wx.h>
 #include <vector>
+#include "Types.h"
 
 class Board; // Forward declaration
 
-enum class PieceType { NONE, PAWN, ROOK, KNIGHT, BISHOP, QUEEN, KING };
-enum class PieceColor { NONE, BLACK, WHITE };
-
 class Piece {
 public:
     Piece(PieceType type, PieceColor color) : type(type), color(color) {}
@@ -16,7 +14,9 @@ public:
     
     virtual wxString GetSymbol() const = 0;
     virtual std::string GetName() const = 0;
-    virtual std::vector<wxPoint> GetPossibleMoves(const Board& board, wxPoint position) const = 0;
+    // Legal destinations from the engine's generator; the subclasses only
+    // supply what the GUI draws
+    std::vector<wxPoint> GetPossibleMoves(const Board& board, wxPoint position) const;
     
     PieceType GetType() const { return type; }
     PieceColor GetColor() const { return color; }
@@ -6,14 +6,23 @@
 #include "Queen.h"
 #include "King.h"
 
-std::unique_ptr<Piece> PieceFactory::CreatePiece(PieceType type, PieceColor color) {
+namespace {
+template <typename T>
+const Piece* Instance(PieceColor color) {
+    static const T white(PieceColor::WHITE);
+    static const T black(PieceColor::BLACK);
+    return (color == PieceColor::WHITE) ? &white : &black;
+}
+}
+
+const Piece* PieceFactory::GetPiece(PieceType type, PieceColor color) {
     switch (type) {
-        case PieceType::PAWN:   return std::make_unique<Pawn>(color);
-        case PieceType::ROOK:   return std::make_unique<Rook>(color);
-        case PieceType::KNIGHT: return std::make_unique<Knight>(color);
-        case PieceType::BISHOP: return std::make_unique<Bishop>(color);
-        case PieceType::QUEEN:  return std::make_unique<Queen>(color);
-        case PieceType::KING:   return std::make_unique<King>(color);
+        case PieceType::PAWN:   return Instance<Pawn>(color);
+        case PieceType::ROOK:   return Instance<Rook>(color);
+        case PieceType::KNIGHT: return Instance<Knight>(color);
+        case PieceType::BISHOP: return Instance<Bishop>(color);
+        case PieceType::QUEEN:  return Instance<Queen>(color);
+        case PieceType::KING:   return Instance<King>(color);
         default:                return nullptr;
     }
 }
@@ -2,11 +2,12 @@
 #define PIECE_FACTORY_H
 
 #include "Piece.h"
-#include <memory>
 
 class PieceFactory {
 public:
-    static std::unique_ptr<Piece> CreatePiece(PieceType type, PieceColor color);
+    // One shared immutable instance per type and color, never freed;
+    // nullptr for PieceType::NONE
+    static const Piece* GetPiece(PieceType type, PieceColor color);
 };
 
 #endif
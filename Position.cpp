@@ -0,0 +1,521 @@
+#include "Position.h"
+#include "MoveGen.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace {
+uint8_t KingsideRight(PieceColor color) {
+    return (color == PieceColor::WHITE) ? WHITE_KINGSIDE : BLACK_KINGSIDE;
+}
+
+uint8_t QueensideRight(PieceColor color) {
+    return (color == PieceColor::WHITE) ? WHITE_QUEENSIDE : BLACK_QUEENSIDE;
+}
+
+// Rights lost when a piece moves from or to the given square
+uint8_t CastlingRightsTouched(Square s) {
+    switch (s) {
+        case 0:  return WHITE_QUEENSIDE;
+        case 4:  return WHITE_KINGSIDE | WHITE_QUEENSIDE;
+        case 7:  return WHITE_KINGSIDE;
+        case 56: return BLACK_QUEENSIDE;
+        case 60: return BLACK_KINGSIDE | BLACK_QUEENSIDE;
+        case 63: return BLACK_KINGSIDE;
+        default: return 0;
+    }
+}
+
+uint64_t EnPassantKey(Square target) {
+    return (target == NO_SQUARE) ? 0 : ZobristEnPassant[FileOf(target)];
+}
+}
+
+Position::Position() {
+    Clear();
+}
+
+void Position::Clear() {
+    for (Bitboard& b : byType) b = 0;
+    for (Bitboard& b : byColor) b = 0;
+    for (Square s = 0; s < 64; ++s) {
+        types[s] = PieceType::NONE;
+        colors[s] = PieceColor::NONE;
+    }
+    sideToMove = PieceColor::WHITE;
+    enPassantTarget = NO_SQUARE;
+    castlingRights = 0;
+    key = 0;
+    pawnKey = 0;
+    psqMidgame = 0;
+    psqEndgame = 0;
+    phase = 0;
+}
+
+void Position::SetStartPosition() {
+    Clear();
+
+    for (int x = 0; x < 8; ++x) {
+        PutPiece(MakeSquare(x, 1), PieceType::PAWN, PieceColor::WHITE);
+        PutPiece(MakeSquare(x, 6), PieceType::PAWN, PieceColor::BLACK);
+    }
+
+    const PieceType backRow[8] = {
+        PieceType::ROOK, PieceType::KNIGHT, PieceType::BISHOP, PieceType::QUEEN,
+        PieceType::KING, PieceType::BISHOP, PieceType::KNIGHT, PieceType::ROOK
+    };
+
+    for (int x = 0; x < 8; ++x) {
+        PutPiece(MakeSquare(x, 0), backRow[x], PieceColor::WHITE);
+        PutPiece(MakeSquare(x, 7), backRow[x], PieceColor::BLACK);
+    }
+    castlingRights = ALL_CASTLING;
+    key = ComputeKey();
+}
+
+bool Position::SetFromFen(const std::string& fen) {
+    Clear();
+
+    std::istringstream fields(fen);
+    std::string placement, side, castling, enPassant;
+    fields >> placement >> side >> castling >> enPassant;
+
+    int x = 0;
+    int y = 7;
+    for (char c : placement) {
+        if (c == '/') {
+            x = 0;
+            --y;
+        } else if (std::isdigit(static_cast<unsigned char>(c))) {
+            x += c - '0';
+        } else {
+            PieceType type;
+            switch (std::tolower(static_cast<unsigned char>(c))) {
+                case 'p': type = PieceType::PAWN; break;
+                case 'n': type = PieceType::KNIGHT; break;
+                case 'b': type = PieceType::BISHOP; break;
+                case 'r': type = PieceType::ROOK; break;
+                case 'q': type = PieceType::QUEEN; break;
+                case 'k': type = PieceType::KING; break;
+                default: Clear(); return false;
+            }
+            if (!IsInsideBoard(x, y)) {
+                Clear();
+                return false;
+            }
+            PutPiece(MakeSquare(x, y), type,
+                     std::isupper(static_cast<unsigned char>(c)) ? PieceColor::WHITE : PieceColor::BLACK);
+            ++x;
+        }
+    }
+
+    // Move generation and evaluation index tables by the king squares
+    if (PopCount(Pieces(PieceType::KING, PieceColor::WHITE)) != 1 ||
+        PopCount(Pieces(PieceType::KING, PieceColor::BLACK)) != 1 ||
+        (side != "w" && side != "b")) {
+        Clear();
+        return false;
+    }
+    sideToMove = (side == "w") ? PieceColor::WHITE : PieceColor::BLACK;
+    // Otherwise the side to move could capture the king
+    if (IsKingInCheck(Opponent(sideToMove))) {
+        Clear();
+        return false;
+    }
+
+    for (char c : castling) {
+        if (c == 'K') castlingRights |= WHITE_KINGSIDE;
+        else if (c == 'Q') castlingRights |= WHITE_QUEENSIDE;
+        else if (c == 'k') castlingRights |= BLACK_KINGSIDE;
+        else if (c == 'q') castlingRights |= BLACK_QUEENSIDE;
+    }
+    // A right only means something with king and rook on their home squares
+    const struct { CastlingRight right; PieceColor color; Square king; Square rook; } homes[] = {
+        { WHITE_KINGSIDE,  PieceColor::WHITE, MakeSquare(4, 0), MakeSquare(7, 0) },
+        { WHITE_QUEENSIDE, PieceColor::WHITE, MakeSquare(4, 0), MakeSquare(0, 0) },
+        { BLACK_KINGSIDE,  PieceColor::BLACK, MakeSquare(4, 7), MakeSquare(7, 7) },
+        { BLACK_QUEENSIDE, PieceColor::BLACK, MakeSquare(4, 7), MakeSquare(0, 7) },
+    };
+    for (const auto& home : homes) {
+        if (!(Pieces(PieceType::KING, home.color) & SquareBB(home.king)) ||
+            !(Pieces(PieceType::ROOK, home.color) & SquareBB(home.rook))) {
+            castlingRights &= ~home.right;
+        }
+    }
+
+    // As in MakeMove, keep the en passant square only if a pawn can take
+    if (enPassant.size() == 2 && enPassant[0] >= 'a' && enPassant[0] <= 'h' &&
+        (enPassant[1] == '3' || enPassant[1] == '6')) {
+        Square target = MakeSquare(enPassant[0] - 'a', enPassant[1] - '1');
+        if (PawnAttacks(target, Opponent(sideToMove)) & Pieces(PieceType::PAWN, sideToMove)) {
+            enPassantTarget = target;
+        }
+    }
+    key = ComputeKey();
+    return true;
+}
+
+uint64_t Position::ComputeKey() const {
+    uint64_t k = ZobristCastling[castlingRights] ^ EnPassantKey(enPassantTarget);
+    if (sideToMove == PieceColor::BLACK) k ^= ZobristSide;
+    for (Bitboard b = Pieces(); b; ) {
+        Square s = PopLsb(b);
+        k ^= PieceKey(colors[s], types[s], s);
+    }
+    return k;
+}
+
+bool Position::IsEmpty(Square s) const {
+    if (s < 0 || s >= 64) return false;
+    return !(Pieces() & SquareBB(s));
+}
+
+bool Position::IsEnemy(Square s, PieceColor color) const {
+    if (s < 0 || s >= 64) return false;
+    return Pieces(Opponent(color)) & SquareBB(s);
+}
+
+void Position::PutPiece(Square s, PieceType type, PieceColor color) {
+    if (types[s] != PieceType::NONE) RemovePiece(s);
+    byType[int(type)] |= SquareBB(s);
+    byColor[int(color)] |= SquareBB(s);
+    types[s] = type;
+    colors[s] = color;
+    key ^= PieceKey(color, type, s);
+    if (type == PieceType::PAWN) pawnKey ^= PieceKey(color, type, s);
+    psqMidgame += PsqMidgame(color, type, s);
+    psqEndgame += PsqEndgame(color, type, s);
+    phase += PHASE_WEIGHTS[int(type)];
+}
+
+void Position::RemovePiece(Square s) {
+    key ^= PieceKey(colors[s], types[s], s);
+    if (types[s] == PieceType::PAWN) pawnKey ^= PieceKey(colors[s], types[s], s);
+    psqMidgame -= PsqMidgame(colors[s], types[s], s);
+    psqEndgame -= PsqEndgame(colors[s], types[s], s);
+    phase -= PHASE_WEIGHTS[int(types[s])];
+    byType[int(types[s])] &= ~SquareBB(s);
+    byColor[int(colors[s])] &= ~SquareBB(s);
+    types[s] = PieceType::NONE;
+    colors[s] = PieceColor::NONE;
+}
+
+void Position::MovePiece(Square from, Square to) {
+    Bitboard fromTo = SquareBB(from) | SquareBB(to);
+    byType[int(types[from])] ^= fromTo;
+    byColor[int(colors[from])] ^= fromTo;
+    key ^= PieceKey(colors[from], types[from], from) ^ PieceKey(colors[from], types[from], to);
+    if (types[from] == PieceType::PAWN) {
+        pawnKey ^= PieceKey(colors[from], types[from], from) ^ PieceKey(colors[from], types[from], to);
+    }
+    psqMidgame += PsqMidgame(colors[from], types[from], to) - PsqMidgame(colors[from], types[from], from);
+    psqEndgame += PsqEndgame(colors[from], types[from], to) - PsqEndgame(colors[from], types[from], from);
+    types[to] = types[from];
+    colors[to] = colors[from];
+    types[from] = PieceType::NONE;
+    colors[from] = PieceColor::NONE;
+}
+
+Square Position::GetKingSquare(PieceColor color) const {
+    Bitboard king = Pieces(PieceType::KING, color);
+    return king ? Lsb(king) : NO_SQUARE;
+}
+
+bool Position::CanCastleKingside(PieceColor color) const {
+    return castlingRights & KingsideRight(color);
+}
+
+bool Position::CanCastleQueenside(PieceColor color) const {
+    return castlingRights & QueensideRight(color);
+}
+
+bool Position::HasCastlingRights(PieceColor color) const {
+    return castlingRights & (KingsideRight(color) | QueensideRight(color));
+}
+
+void Position::SetKingMoved(PieceColor color) {
+    SetCastlingRights(castlingRights & ~(KingsideRight(color) | QueensideRight(color)));
+}
+
+void Position::SetRookMoved(Square s) {
+    SetCastlingRights(castlingRights & ~CastlingRightsTouched(s));
+}
+
+void Position::SetCastlingRights(uint8_t rights) {
+    key ^= ZobristCastling[castlingRights] ^ ZobristCastling[rights];
+    castlingRights = rights;
+}
+
+void Position::SetEnPassantTarget(Square target) {
+    key ^= EnPassantKey(enPassantTarget) ^ EnPassantKey(target);
+    enPassantTarget = target;
+}
+
+Bitboard Position::GetAttacks(Square s) const {
+    switch (types[s]) {
+        case PieceType::PAWN:   return PawnAttacks(s, colors[s]);
+        case PieceType::KNIGHT: return KnightAttacks(s);
+        case PieceType::BISHOP: return BishopAttacks(s, Pieces());
+        case PieceType::ROOK:   return RookAttacks(s, Pieces());
+        case PieceType::QUEEN:  return QueenAttacks(s, Pieces());
+        case PieceType::KING:   return KingAttacks(s);
+        default:                return 0;
+    }
+}
+
+Bitboard Position::AttackersTo(Square s, Bitboard occupied) const {
+    Bitboard diagonal = Pieces(PieceType::BISHOP) | Pieces(PieceType::QUEEN);
+    Bitboard straight = Pieces(PieceType::ROOK) | Pieces(PieceType::QUEEN);
+
+    // A pawn of one color attacks s exactly when a pawn of the other color
+    // standing on s would attack the pawn's square
+    return (PawnAttacks(s, PieceColor::BLACK) & Pieces(PieceType::PAWN, PieceColor::WHITE))
+         | (PawnAttacks(s, PieceColor::WHITE) & Pieces(PieceType::PAWN, PieceColor::BLACK))
+         | (KnightAttacks(s) & Pieces(PieceType::KNIGHT))
+         | (KingAttacks(s) & Pieces(PieceType::KING))
+         | (BishopAttacks(s, occupied) & diagonal)
+         | (RookAttacks(s, occupied) & straight);
+}
+
+bool Position::IsSquareUnderAttack(Square square, PieceColor attackerColor) const {
+    // Look outward from the square for an attacker of each kind, cheapest
+    // tests first
+    Bitboard attackers = Pieces(attackerColor);
+    if (PawnAttacks(square, Opponent(attackerColor)) & attackers & Pieces(PieceType::PAWN)) return true;
+    if (KnightAttacks(square) & attackers & Pieces(PieceType::KNIGHT)) return true;
+    if (KingAttacks(square) & attackers & Pieces(PieceType::KING)) return true;
+
+    Bitboard queens = Pieces(PieceType::QUEEN);
+    Bitboard diagonal = attackers & (Pieces(PieceType::BISHOP) | queens);
+    Bitboard straight = attackers & (Pieces(PieceType::ROOK) | queens);
+    return (diagonal && (BishopAttacks(square, Pieces()) & diagonal))
+        || (straight && (RookAttacks(square, Pieces()) & straight));
+}
+
+Bitboard Position::Checkers() const {
+    Square king = GetKingSquare(sideToMove);
+    if (king == NO_SQUARE) return 0;
+    return AttackersTo(king, Pieces()) & Pieces(Opponent(sideToMove));
+}
+
+Bitboard Position::PinnedPieces(PieceColor color) const {
+    Square king = GetKingSquare(color);
+    if (king == NO_SQUARE) return 0;
+
+    PieceColor them = Opponent(color);
+    Bitboard queens = Pieces(PieceType::QUEEN, them);
+    Bitboard snipers = (RookAttacks(king, 0) & (Pieces(PieceType::ROOK, them) | queens))
+                     | (BishopAttacks(king, 0) & (Pieces(PieceType::BISHOP, them) | queens));
+
+    Bitboard pinned = 0;
+    while (snipers) {
+        Bitboard blockers = BetweenBB(king, PopLsb(snipers)) & Pieces();
+        if (blockers && !MoreThanOne(blockers)) {
+            pinned |= blockers & Pieces(color);
+        }
+    }
+    return pinned;
+}
+
+bool Position::IsKingInCheck(PieceColor color) const {
+    Square kingPos = GetKingSquare(color);
+    if (kingPos == NO_SQUARE) return false;
+    return IsSquareUnderAttack(kingPos, Opponent(color));
+}
+
+std::vector<Square> Position::GetCheckingPieces(PieceColor color) const {
+    std::vector<Square> checkers;
+    Square kingPos = GetKingSquare(color);
+    if (kingPos == NO_SQUARE) return checkers;
+
+    Bitboard attackers = AttackersTo(kingPos, Pieces()) & Pieces(Opponent(color));
+    while (attackers) {
+        checkers.push_back(PopLsb(attackers));
+    }
+    return checkers;
+}
+
+bool Position::HasNonPawnMaterial(PieceColor color) const {
+    return Pieces(color) & ~Pieces(PieceType::PAWN) & ~Pieces(PieceType::KING);
+}
+
+bool Position::HasLegalMoves() const {
+    MoveList moves;
+    GenerateLegalMoves(*this, moves);
+    return !moves.Empty();
+}
+
+bool Position::IsCheckmate() const {
+    if (!IsKingInCheck(sideToMove)) return false;
+    return !HasLegalMoves();
+}
+
+bool Position::IsStalemate() const {
+    if (IsKingInCheck(sideToMove)) return false;
+    return !HasLegalMoves();
+}
+
+int Position::See(Move move) const {
+    if (move.IsCastle()) return 0;
+
+    Square from = move.From();
+    Square to = move.To();
+    Bitboard occupied = Pieces() ^ SquareBB(from);
+    PieceType victim = GetPieceType(to);
+    PieceType onTarget = GetPieceType(from);
+    if (move.IsEnPassant()) {
+        victim = PieceType::PAWN;
+        occupied ^= SquareBB(MakeSquare(FileOf(to), RankOf(from)));
+    }
+
+    // gain[d]: what the side capturing at step d has won if the exchange
+    // stopped right after its capture
+    int gain[32];
+    int d = 0;
+    gain[0] = PieceValue(victim);
+    if (move.IsPromotion()) {
+        onTarget = move.PromotionType();
+        gain[0] += PieceValue(onTarget) - PieceValue(PieceType::PAWN);
+    }
+
+    const PieceType order[] = {
+        PieceType::PAWN, PieceType::KNIGHT, PieceType::BISHOP,
+        PieceType::ROOK, PieceType::QUEEN, PieceType::KING
+    };
+    PieceColor side = Opponent(GetPieceColor(from));
+    // Recomputed after every capture so sliders behind the capturer join in
+    Bitboard attackers = AttackersTo(to, occupied) & occupied;
+    while (d < 31) {
+        Bitboard ours = attackers & Pieces(side);
+        if (!ours) break;
+
+        PieceType next = PieceType::NONE;
+        Square square = NO_SQUARE;
+        for (PieceType type : order) {
+            if (ours & Pieces(type)) {
+                next = type;
+                square = Lsb(ours & Pieces(type));
+                break;
+            }
+        }
+        // The king may only take last
+        if (next == PieceType::KING && (attackers & Pieces(Opponent(side)))) break;
+
+        ++d;
+        gain[d] = PieceValue(onTarget) - gain[d - 1];
+        occupied ^= SquareBB(square);
+        attackers = AttackersTo(to, occupied) & occupied;
+        onTarget = next;
+        side = Opponent(side);
+    }
+
+    // Either side may stop capturing when going on would lose material
+    while (d > 0) {
+        gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+        --d;
+    }
+    return gain[0];
+}
+
+void Position::MakeMove(Move move, UndoInfo& undo) {
+    Square from = move.From();
+    Square to = move.To();
+    PieceColor movedColor = sideToMove;
+
+    undo.capturedType = types[to];
+    undo.enPassantTarget = enPassantTarget;
+    undo.castlingRights = castlingRights;
+    undo.key = key;
+
+    if (move.IsEnPassant()) {
+        undo.capturedType = PieceType::PAWN;
+        RemovePiece((movedColor == PieceColor::WHITE) ? to - 8 : to + 8);
+    } else if (undo.capturedType != PieceType::NONE) {
+        RemovePiece(to);
+    }
+
+    if (move.Flags() == KING_CASTLE) {
+        MovePiece(to + 1, to - 1);
+    } else if (move.Flags() == QUEEN_CASTLE) {
+        MovePiece(to - 2, to + 1);
+    }
+
+    // Moving the king or a rook, or capturing a rook on its home square,
+    // loses the matching castling rights
+    SetCastlingRights(castlingRights & ~(CastlingRightsTouched(from) | CastlingRightsTouched(to)));
+
+    // The en passant square only enters the key when a capture there is
+    // possible, so transpositions with and without a double push match
+    Square target = NO_SQUARE;
+    if (move.Flags() == DOUBLE_PAWN_PUSH &&
+        (PawnAttacks((from + to) / 2, movedColor) & Pieces(PieceType::PAWN, Opponent(movedColor)))) {
+        target = (from + to) / 2;
+    }
+    SetEnPassantTarget(target);
+
+    MovePiece(from, to);
+
+    if (move.IsPromotion()) {
+        PutPiece(to, move.PromotionType(), movedColor);
+    }
+
+    sideToMove = Opponent(sideToMove);
+    key ^= ZobristSide;
+}
+
+void Position::UnmakeMove(Move move, const UndoInfo& undo) {
+    Square from = move.From();
+    Square to = move.To();
+    sideToMove = Opponent(sideToMove);
+    PieceColor movedColor = sideToMove;
+
+    if (move.IsPromotion()) {
+        PutPiece(to, PieceType::PAWN, movedColor);
+    }
+
+    MovePiece(to, from);
+
+    if (move.Flags() == KING_CASTLE) {
+        MovePiece(to - 1, to + 1);
+    } else if (move.Flags() == QUEEN_CASTLE) {
+        MovePiece(to + 1, to - 2);
+    }
+
+    if (move.IsEnPassant()) {
+        PutPiece((movedColor == PieceColor::WHITE) ? to - 8 : to + 8, PieceType::PAWN, Opponent(movedColor));
+    } else if (undo.capturedType != PieceType::NONE) {
+        PutPiece(to, undo.capturedType, Opponent(movedColor));
+    }
+
+    enPassantTarget = undo.enPassantTarget;
+    castlingRights = undo.castlingRights;
+    key = undo.key;
+}
+
+void Position::MakeNullMove(UndoInfo& undo) {
+    undo.capturedType = PieceType::NONE;
+    undo.enPassantTarget = enPassantTarget;
+    undo.castlingRights = castlingRights;
+    undo.key = key;
+
+    SetEnPassantTarget(NO_SQUARE);
+    sideToMove = Opponent(sideToMove);
+    key ^= ZobristSide;
+}
+
+void Position::UnmakeNullMove(const UndoInfo& undo) {
+    sideToMove = Opponent(sideToMove);
+    enPassantTarget = undo.enPassantTarget;
+    key = undo.key;
+}
+
+void Position::DoMove(Move move) {
+    UndoInfo undo;
+    MakeMove(move, undo);
+}
+
+void Position::PromotePawn(Square s, PieceType promotionType) {
+    if (types[s] == PieceType::PAWN) {
+        PutPiece(s, promotionType, colors[s]);
+    }
+}
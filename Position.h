@@ -0,0 +1,132 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <string>
+#include <vector>
+#include "Bitboard.h"
+#include "Move.h"
+#include "Psqt.h"
+#include "Types.h"
+#include "Zobrist.h"
+
+// Castling rights, one bit per side and wing.
+enum CastlingRight : uint8_t {
+    WHITE_KINGSIDE = 1,
+    WHITE_QUEENSIDE = 2,
+    BLACK_KINGSIDE = 4,
+    BLACK_QUEENSIDE = 8,
+    ALL_CASTLING = 15
+};
+
+// What MakeMove changed that the move itself does not tell UnmakeMove.
+// Kept trivially copyable so the search can hold one per ply on its stack.
+struct UndoInfo {
+    PieceType capturedType;
+    Square enPassantTarget;
+    uint8_t castlingRights;
+    uint64_t key;
+};
+
+// Rules-only chess position. Contains no GUI types so it can be used by the
+// search engine, benchmarks and tools without a display.
+//
+// Piece placement is kept as bitboards (one set per piece type and per
+// color); the square-indexed mailbox is maintained alongside them for O(1)
+// "what is on this square" queries and for the GUI.
+class Position {
+public:
+    Position();
+    void Clear();
+    void SetStartPosition();
+    // Loads a position in Forsyth-Edwards Notation; returns false (leaving
+    // the position cleared) if the placement or side to move is malformed
+    bool SetFromFen(const std::string& fen);
+
+    bool IsEmpty(Square s) const;
+    bool IsEnemy(Square s, PieceColor color) const;
+    PieceType GetPieceType(Square s) const { return types[s]; }
+    PieceColor GetPieceColor(Square s) const { return colors[s]; }
+    void PutPiece(Square s, PieceType type, PieceColor color);
+    void RemovePiece(Square s);
+
+    // Material plus piece-square score from White's point of view, kept up
+    // to date as pieces move, and the game phase to blend it with
+    int GetMidgameScore() const { return psqMidgame; }
+    int GetEndgameScore() const { return psqEndgame; }
+    int GetPhase() const { return phase; }
+
+    Bitboard Pieces() const { return byColor[int(PieceColor::WHITE)] | byColor[int(PieceColor::BLACK)]; }
+    Bitboard Pieces(PieceColor color) const { return byColor[int(color)]; }
+    Bitboard Pieces(PieceType type) const { return byType[int(type)]; }
+    Bitboard Pieces(PieceType type, PieceColor color) const { return byType[int(type)] & byColor[int(color)]; }
+    // Squares attacked by the piece on s, given the current occupancy
+    Bitboard GetAttacks(Square s) const;
+    // Pieces of both colors attacking s, with sliders seen through 'occupied'
+    Bitboard AttackersTo(Square s, Bitboard occupied) const;
+    // Enemy pieces giving check to the side to move
+    Bitboard Checkers() const;
+    // Pieces of 'color' that may not leave the line between their king and
+    // an enemy slider
+    Bitboard PinnedPieces(PieceColor color) const;
+
+    // Zobrist key of the position, kept up to date by every mutator
+    uint64_t GetKey() const { return key; }
+    // The same key recomputed from scratch, for setup and consistency checks
+    uint64_t ComputeKey() const;
+    // Zobrist key of the pawns alone, for the pawn structure cache
+    uint64_t GetPawnKey() const { return pawnKey; }
+
+    PieceColor GetSideToMove() const { return sideToMove; }
+    Square GetEnPassantTarget() const { return enPassantTarget; }
+    uint8_t GetCastlingRights() const { return castlingRights; }
+    void SetEnPassantTarget(Square target);
+    Square GetKingSquare(PieceColor color) const;
+
+    bool CanCastleKingside(PieceColor color) const;
+    bool CanCastleQueenside(PieceColor color) const;
+    bool HasCastlingRights(PieceColor color) const;
+    void SetKingMoved(PieceColor color);
+    void SetRookMoved(Square s);
+
+    bool IsSquareUnderAttack(Square square, PieceColor attackerColor) const;
+    bool IsKingInCheck(PieceColor color) const;
+    std::vector<Square> GetCheckingPieces(PieceColor color) const;
+    // Static exchange evaluation: material won by the side making 'move'
+    // once both sides have made every profitable recapture on its target
+    int See(Move move) const;
+    // The following refer to the side to move
+    bool HasLegalMoves() const;
+    // Anything besides king and pawns; without it zugzwang is common
+    bool HasNonPawnMaterial(PieceColor color) const;
+    bool IsCheckmate() const;
+    bool IsStalemate() const;
+
+    // Incremental move application. MakeMove fills 'undo' with what is
+    // needed to take the move back; no allocation happens in either call.
+    void MakeMove(Move move, UndoInfo& undo);
+    void UnmakeMove(Move move, const UndoInfo& undo);
+    // Passes the turn without moving, for null-move pruning
+    void MakeNullMove(UndoInfo& undo);
+    void UnmakeNullMove(const UndoInfo& undo);
+    void DoMove(Move move);
+    void PromotePawn(Square s, PieceType promotionType);
+
+private:
+    void MovePiece(Square from, Square to);
+    void SetCastlingRights(uint8_t rights);
+
+    Bitboard byType[7];
+    Bitboard byColor[3];
+    PieceType types[64];
+    PieceColor colors[64];
+    PieceColor sideToMove = PieceColor::WHITE;
+    Square enPassantTarget = NO_SQUARE;
+    uint8_t castlingRights = 0;
+    uint64_t key = 0;
+    uint64_t pawnKey = 0;
+    int psqMidgame = 0;
+    int psqEndgame = 0;
+    int phase = 0;
+};
+
+#endif // POSITION_H
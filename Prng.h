@@ -0,0 +1,23 @@
+#ifndef PRNG_H
+#define PRNG_H
+
+#include <cstdint>
+
+// xorshift64*; a fixed seed keeps generated tables (magics, hash keys)
+// identical from run to run
+class Prng {
+public:
+    explicit Prng(uint64_t seed) : state(seed) {}
+    uint64_t Next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+    uint64_t Sparse() { return Next() & Next() & Next(); }
+
+private:
+    uint64_t state;
+};
+
+#endif // PRNG_H
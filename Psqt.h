@@ -0,0 +1,29 @@
+#ifndef PSQT_H
+#define PSQT_H
+
+#include "Types.h"
+
+// Game phase from the non-pawn material on the board: MAX_PHASE with the
+// starting set, 0 with kings and pawns only. Indexed by PieceType.
+constexpr int PHASE_WEIGHTS[7] = { 0, 0, 2, 1, 1, 4, 0 };
+constexpr int MAX_PHASE = 24;
+
+// Material plus piece-square bonus of a piece on a square, for the
+// middlegame and the endgame, from White's point of view (black pieces
+// count negative). Computed at compile time, see Psqt.cpp.
+struct PsqTables {
+    int midgame[3][7][64];
+    int endgame[3][7][64];
+};
+
+extern const PsqTables Psq;
+
+inline int PsqMidgame(PieceColor color, PieceType type, Square s) {
+    return Psq.midgame[int(color)][int(type)][s];
+}
+
+inline int PsqEndgame(PieceColor color, PieceType type, Square s) {
+    return Psq.endgame[int(color)][int(type)][s];
+}
+
+#endif // PSQT_H
@@ -1,5 +1,4 @@
 #include "Queen.h"
-#include "Board.h"
 Queen::Queen(PieceColor color) 
     : Piece(PieceType::QUEEN, color) {}
 
@@ -10,31 +9,3 @@ wxString Queen::GetSymbol() const {
 std::string Queen::GetName() const {
     return "Queen";
 }
-
-std::vector<wxPoint> Queen::GetPossibleMoves(const Board& board, wxPoint pos) const {
-    std::vector<wxPoint> moves;
-    const std::vector<wxPoint> directions = {
-        {1,0}, {-1,0}, {0,1}, {0,-1},
-        {1,1}, {-1,1}, {1,-1}, {-1,-1}
-    };
-
-    for (auto dir : directions) {
-        wxPoint p = pos;
-        while (true) {
-            p.x += dir.x;
-            p.y += dir.y;
-            if (!board.IsInsideBoard(p)) break;
-
-            if (board.IsEmpty(p.x, p.y)) {
-                moves.push_back(p);
-            } else {
-                if (board.IsEnemy(p.x, p.y, GetColor())) {
-                    moves.push_back(p);
-                }
-                break;
-            }
-        }
-    }
-
-    return moves;
-}
@@ -8,7 +8,6 @@ public:
     Queen(PieceColor color);
     wxString GetSymbol() const override;
     std::string GetName() const override;
-    std::vector<wxPoint> GetPossibleMoves(const Board& board, wxPoint pos) const override;
 };
 
 #endif
@@ -8,7 +8,6 @@ public:
     Rook(PieceColor color);
     wxString GetSymbol() const override;
     std::string GetName() const override;
-    std::vector<wxPoint> GetPossibleMoves(const Board& board, wxPoint position) const override;
 };
 
 #endif
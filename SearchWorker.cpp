@@ -0,0 +1,539 @@
+#include "SearchWorker.h"
+#include "Engine.h"
+#include "MoveGen.h"
+#include "MovePicker.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Mate scores count plies from the root; the table stores them counted
+// from the node so that they stay valid when reached along another path
+int ScoreToTT(int score, int ply) {
+    if (score >= MATE_IN_MAX_PLY) return score + ply;
+    if (score <= -MATE_IN_MAX_PLY) return score - ply;
+    return score;
+}
+
+int ScoreFromTT(int score, int ply) {
+    if (score >= MATE_IN_MAX_PLY) return score - ply;
+    if (score <= -MATE_IN_MAX_PLY) return score + ply;
+    return score;
+}
+
+// Late move reductions grow with both the remaining depth and the move's
+// place in the ordering
+struct ReductionTable {
+    int8_t value[MAX_SEARCH_DEPTH + 1][MAX_MOVES];
+    ReductionTable() {
+        for (int d = 0; d <= MAX_SEARCH_DEPTH; ++d) {
+            for (int m = 0; m < MAX_MOVES; ++m) {
+                value[d][m] = (d < 1 || m < 1) ? 0 : int8_t(0.75 + std::log(d) * std::log(m) / 2.25);
+            }
+        }
+    }
+};
+const ReductionTable kReductions;
+}
+
+// Static evaluation, looked up in the engine's evaluation cache first
+int SearchWorker::Evaluate() {
+    evalProbes.store(evalProbes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    int score;
+    if (engine.evalCache.Probe(position.GetKey(), score)) {
+        evalHits.store(evalHits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return score;
+    }
+    score = EvaluateBoard();
+    engine.evalCache.Store(position.GetKey(), score);
+    return score;
+}
+
+int SearchWorker::EvaluateBoard() {
+    // An untrained network's output is unbounded; keep it clear of mate scores
+    if (network) return std::clamp(accumulators.Evaluate(position, *network), -MATE_IN_MAX_PLY + 1, MATE_IN_MAX_PLY - 1);
+    return classical.Evaluate(position);
+}
+
+// Moves on the search's position also keep the network's accumulators in
+// step when it is in use
+void SearchWorker::MakeMove(Move move, UndoInfo& undo) {
+    if (network) accumulators.Push(position, move);
+    position.MakeMove(move, undo);
+}
+
+void SearchWorker::UnmakeMove(Move move, const UndoInfo& undo) {
+    position.UnmakeMove(move, undo);
+    if (network) accumulators.Pop();
+}
+
+void SearchWorker::MakeNullMove(UndoInfo& undo) {
+    if (network) accumulators.PushNull();
+    position.MakeNullMove(undo);
+}
+
+void SearchWorker::UnmakeNullMove(const UndoInfo& undo) {
+    position.UnmakeNullMove(undo);
+    if (network) accumulators.Pop();
+}
+
+// The reply that last refuted the opponent's previous move
+Move SearchWorker::CounterMoveFor(int ply) const {
+    // Nothing to answer at the root or after a null move
+    if (ply == 0 || moveStack[ply - 1].IsNone()) return Move::None();
+    Square to = moveStack[ply - 1].To();
+    return counterMoves[int(position.GetPieceColor(to))][int(position.GetPieceType(to))][to];
+}
+
+// A quiet move caused a cutoff: remember it as a killer and counter move,
+// credit its history and debit the quiet moves searched before it
+void SearchWorker::UpdateQuietStats(Move move, int depth, int ply, const Move* quietsTried, int quietCount) {
+    if (killers[ply][0] != move) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = move;
+    }
+    if (ply > 0 && !moveStack[ply - 1].IsNone()) {
+        Square to = moveStack[ply - 1].To();
+        counterMoves[int(position.GetPieceColor(to))][int(position.GetPieceType(to))][to] = move;
+    }
+
+    // Scaled so that entries saturate at +-HISTORY_MAX instead of overflowing
+    auto update = [this](Move m, int bonus) {
+        int& entry = history[int(position.GetSideToMove())][m.From()][m.To()];
+        entry += bonus - entry * std::abs(bonus) / HISTORY_MAX;
+    };
+    int bonus = std::min(depth * depth, 400);
+    update(move, bonus);
+    for (int i = 0; i < quietCount; ++i) {
+        update(quietsTried[i], -bonus);
+    }
+}
+
+void SearchWorker::UpdatePv(int ply, Move move) {
+    pvTable[ply][ply] = move;
+    for (int i = ply + 1; i < pvLength[ply + 1]; ++i) {
+        pvTable[ply][i] = pvTable[ply + 1][i];
+    }
+    pvLength[ply] = std::max(pvLength[ply + 1], ply + 1);
+}
+
+void SearchWorker::CountNode() {
+    uint64_t count = nodes.load(std::memory_order_relaxed) + 1;
+    nodes.store(count, std::memory_order_relaxed);
+    // The clock is only read every 1024 nodes; in between the stop flag is enough
+    if ((count & 1023) == 0) engine.CheckTime();
+}
+
+// Searches captures and promotions only, until the position is quiet, so
+// that the evaluation is never taken in the middle of an exchange. The side
+// to move may also "stand pat" on the static evaluation instead.
+int SearchWorker::Quiescence(int ply, int alpha, int beta) {
+    CountNode();
+    pvLength[ply] = ply;
+    if (ply >= MAX_PLY - 1 || engine.IsTimeOut()) {
+        return Evaluate();
+    }
+
+    // In check every evasion is searched and standing pat is not allowed
+    bool inCheck = position.Checkers() != 0;
+    MoveList moves;
+    int standPat = 0;
+    int bestValue;
+    if (inCheck) {
+        GenerateLegalMoves(position, moves);
+        if (moves.Empty()) return -MATE_SCORE + ply;
+        bestValue = -INFINITE_SCORE;
+    } else {
+        standPat = Evaluate();
+        if (standPat >= beta) return standPat;
+        alpha = std::max(alpha, standPat);
+        bestValue = standPat;
+        GenerateLegalCaptures(position, moves);
+    }
+
+    int scores[MAX_MOVES];
+    for (int i = 0; i < moves.Size(); ++i) {
+        scores[i] = CaptureScore(position, moves[i]);
+    }
+
+    // Delta pruning margin: how much the position may swing on top of the
+    // captured material
+    const int deltaMargin = 200;
+
+    for (int i = 0; i < moves.Size(); ++i) {
+        // Selection sort: a cutoff usually comes before the list is used up
+        int best = i;
+        for (int j = i + 1; j < moves.Size(); ++j) {
+            if (scores[j] > scores[best]) best = j;
+        }
+        std::swap(moves[i], moves[best]);
+        std::swap(scores[i], scores[best]);
+        Move move = moves[i];
+
+        if (!inCheck) {
+            if (move.IsPromotion() && move.PromotionType() != PieceType::QUEEN) continue;
+
+            // Skip captures that cannot bring the score back into the window
+            // even if the captured piece comes for free
+            PieceType victim = move.IsEnPassant() ? PieceType::PAWN : position.GetPieceType(move.To());
+            int gain = PieceValue(victim) + deltaMargin;
+            if (move.IsPromotion()) gain += PieceValue(PieceType::QUEEN) - PieceValue(PieceType::PAWN);
+            if (standPat + gain <= alpha) continue;
+
+            // and captures that lose material
+            if (position.See(move) < 0) continue;
+        }
+
+        UndoInfo undo;
+        MakeMove(move, undo);
+        int value = -Quiescence(ply + 1, -beta, -alpha);
+        UnmakeMove(move, undo);
+
+        if (value > bestValue) {
+            bestValue = value;
+            alpha = std::max(alpha, value);
+            if (alpha >= beta) break;
+        }
+    }
+
+    return bestValue;
+}
+
+// Negamax: scores are from the side to move's point of view. A window wider
+// than one point marks a PV node; every other node only has to prove that
+// its score is on one side of the window (principal variation search).
+int SearchWorker::Negamax(int depth, int ply, int alpha, int beta, bool nullAllowed) {
+    if (depth <= 0) {
+        return Quiescence(ply, alpha, beta);
+    }
+
+    CountNode();
+    pvLength[ply] = ply;
+    if (ply >= MAX_PLY - 1 || engine.IsTimeOut()) {
+        return Evaluate();
+    }
+
+    bool pvNode = beta - alpha > 1;
+
+    // Mate distance pruning: no line from here can beat a shorter mate
+    // that is already known
+    alpha = std::max(alpha, -MATE_SCORE + ply);
+    beta = std::min(beta, MATE_SCORE - ply - 1);
+    if (alpha >= beta) return alpha;
+
+    TTEntry entry;
+    Move ttMove = Move::None();
+    if (engine.tt.Probe(position.GetKey(), entry)) {
+        ttMove = entry.move;
+        // PV nodes search on so that the PV is not cut short
+        if (entry.depth >= depth && !pvNode && !followPv) {
+            int score = ScoreFromTT(entry.score, ply);
+            if (entry.bound == Bound::EXACT ||
+                (entry.bound == Bound::LOWER && score >= beta) ||
+                (entry.bound == Bound::UPPER && score <= alpha)) {
+                return score;
+            }
+        }
+    }
+
+    Move pvMove = Move::None();
+    if (followPv) {
+        if (ply < previousPvLength) pvMove = previousPv[ply];
+        else followPv = false;
+    }
+
+    PieceColor currentColor = position.GetSideToMove();
+    bool inCheck = position.IsKingInCheck(currentColor);
+    const PruningParams& pruning = engine.pruning;
+
+    // Pruning near the leaves trusts the static evaluation, so it is not
+    // done in check, at PV nodes or along the previous PV
+    bool canPrune = !pvNode && !followPv && !inCheck;
+    int staticEval = canPrune ? Evaluate() : -INFINITE_SCORE;
+
+    // Reverse futility (static null move): far enough above beta that no
+    // reply is likely to bring the score back within the remaining depth
+    if (canPrune && depth <= pruning.reverseFutilityDepth && beta < MATE_IN_MAX_PLY &&
+        staticEval - pruning.reverseFutilityMargin * depth >= beta) {
+        return staticEval;
+    }
+
+    // Razoring: far below alpha, only captures can still help, so let the
+    // quiescence search confirm the fail low
+    if (canPrune && depth <= pruning.razoringDepth &&
+        staticEval + pruning.razoringMargin * depth <= alpha) {
+        int value = Quiescence(ply, alpha, beta);
+        if (value <= alpha) return value;
+    }
+
+    // Null move: if passing the turn still fails high, a real move would
+    // too. Not twice in a row and not without pieces, where zugzwang makes
+    // passing the best move.
+    if (canPrune && nullAllowed && depth >= 3 && beta < MATE_IN_MAX_PLY &&
+        position.HasNonPawnMaterial(currentColor) && staticEval >= beta) {
+        int reduction = (depth > 6) ? 3 : 2;
+        UndoInfo undo;
+        moveStack[ply] = Move::None();
+        MakeNullMove(undo);
+        int value = -Negamax(depth - 1 - reduction, ply + 1, -beta, -beta + 1, false);
+        UnmakeNullMove(undo);
+
+        if (engine.IsTimeOut()) return value;
+        // Mate scores found after a pass prove nothing
+        if (value >= beta) return value >= MATE_IN_MAX_PLY ? beta : value;
+    }
+
+    // The previous iteration's PV move goes first, then the table's move
+    MovePicker picker(position, pvMove.IsNone() ? ttMove : pvMove, killers[ply],
+                      CounterMoveFor(ply), history);
+
+    int originalAlpha = alpha;
+    int bestValue = -INFINITE_SCORE;
+    Move bestMove = Move::None();
+    int moveCount = 0;
+    Move quietsTried[MAX_MOVES];
+    int quietCount = 0;
+
+    // Generuj tylko ruchy dla aktualnego koloru
+    for (Move move = picker.Next(); !move.IsNone(); move = picker.Next()) {
+        ++moveCount;
+        // Only the first (PV) child continues along the previous PV
+        if (move != pvMove) followPv = false;
+
+        bool quiet = !move.IsCapture() && !move.IsPromotion();
+        int moveHistory = quiet ? history[int(currentColor)][move.From()][move.To()] : 0;
+
+        UndoInfo undo;
+        moveStack[ply] = move;
+        MakeMove(move, undo);
+        bool givesCheck = position.IsKingInCheck(position.GetSideToMove());
+
+        // Quiet moves that do not give check are skipped once a move has
+        // been searched and they are either too late in the ordering or the
+        // evaluation is too far below alpha for them to matter
+        if (canPrune && quiet && !givesCheck && bestValue > -MATE_IN_MAX_PLY) {
+            bool lateMove = depth <= pruning.lateMovePruningDepth &&
+                            moveCount > pruning.lateMovePruningBase + depth * depth;
+            bool futile = depth <= pruning.futilityDepth &&
+                          staticEval + pruning.futilityMargin * depth <= alpha;
+            if (lateMove || futile) {
+                UnmakeMove(move, undo);
+                continue;
+            }
+        }
+
+        int value;
+        if (moveCount == 1) {
+            value = -Negamax(depth - 1, ply + 1, -beta, -alpha);
+        } else {
+            // Late quiet moves are searched shallower; only if one beats
+            // alpha anyway is it searched again to full depth
+            int reduction = 0;
+            if (depth >= 3 && moveCount > 3 && quiet && !inCheck && !givesCheck) {
+                reduction = kReductions.value[std::min(depth, MAX_SEARCH_DEPTH)][std::min(moveCount, MAX_MOVES - 1)];
+                reduction -= moveHistory / (HISTORY_MAX / 2);
+                if (pvNode) --reduction;
+                reduction = std::max(0, std::min(reduction, depth - 2));
+            }
+
+            // Every move after the first is expected to be worse, which a
+            // null window proves cheaply; a move that is not gets a full one
+            value = -Negamax(depth - 1 - reduction, ply + 1, -alpha - 1, -alpha);
+            if (value > alpha && reduction > 0) {
+                value = -Negamax(depth - 1, ply + 1, -alpha - 1, -alpha);
+            }
+            if (value > alpha && value < beta) {
+                value = -Negamax(depth - 1, ply + 1, -beta, -alpha);
+            }
+        }
+
+        UnmakeMove(move, undo);
+        followPv = false;
+
+        if (value > bestValue) {
+            bestValue = value;
+            bestMove = move;
+            if (value > alpha) {
+                alpha = value;
+                // Only moves strictly inside the window belong to the PV
+                if (value < beta) UpdatePv(ply, move);
+            }
+        }
+
+        // Przycinanie alfa-beta
+        if (alpha >= beta) {
+            if (quiet) {
+                UpdateQuietStats(move, depth, ply, quietsTried, quietCount);
+            }
+            break;
+        }
+        if (quiet) {
+            quietsTried[quietCount++] = move;
+        }
+    }
+
+    if (moveCount == 0) {
+        followPv = false;
+        // Brak legalnych ruchów - sprawdź szach/mat; a quicker mate scores higher
+        return inCheck ? -MATE_SCORE + ply : 0;
+    }
+
+    // A search cut short by the clock has unreliable scores
+    if (!engine.IsTimeOut()) {
+        Bound bound = (bestValue <= originalAlpha) ? Bound::UPPER
+                    : (bestValue >= beta) ? Bound::LOWER : Bound::EXACT;
+        engine.tt.Store(position.GetKey(), bestMove, ScoreToTT(bestValue, ply), depth, bound);
+    }
+
+    return bestValue;
+}
+
+Move SearchWorker::SearchRoot(int depth, int alpha, int beta, int& bestValue) {
+    bestValue = -INFINITE_SCORE;
+    Move bestMove = Move::None();
+    int originalAlpha = alpha;
+    pvLength[0] = 0;
+
+    TTEntry entry;
+    Move ttMove = engine.tt.Probe(position.GetKey(), entry) ? entry.move : Move::None();
+    Move pvMove = (previousPvLength > 0) ? previousPv[0] : Move::None();
+    followPv = !pvMove.IsNone();
+
+    MovePicker picker(position, pvMove.IsNone() ? ttMove : pvMove, killers[0], Move::None(), history);
+
+    int moveCount = 0;
+    for (Move move = picker.Next(); !move.IsNone(); move = picker.Next()) {
+        if (engine.IsTimeOut()) {
+            break;
+        }
+        ++moveCount;
+        if (move != pvMove) followPv = false;
+
+        UndoInfo undo;
+        moveStack[0] = move;
+        MakeMove(move, undo);
+
+        int value;
+        if (moveCount == 1) {
+            value = -Negamax(depth - 1, 1, -beta, -alpha);
+        } else {
+            value = -Negamax(depth - 1, 1, -alpha - 1, -alpha);
+            if (value > alpha && value < beta) {
+                value = -Negamax(depth - 1, 1, -beta, -alpha);
+            }
+        }
+
+        UnmakeMove(move, undo);
+        followPv = false;
+
+        if (value > bestValue) {
+            bestValue = value;
+            bestMove = move;
+            if (value > alpha) {
+                alpha = value;
+                UpdatePv(0, move);
+                if (alpha >= beta) break;
+            }
+        }
+    }
+
+    if (!bestMove.IsNone() && !engine.IsTimeOut()) {
+        Bound bound = (bestValue <= originalAlpha) ? Bound::UPPER
+                    : (bestValue >= beta) ? Bound::LOWER : Bound::EXACT;
+        engine.tt.Store(position.GetKey(), bestMove, ScoreToTT(bestValue, 0), depth, bound);
+    }
+    return bestMove;
+}
+
+SearchWorker::SearchWorker(Engine& engine, int id) : engine(engine), id(id) {
+    ClearHistory();
+}
+
+void SearchWorker::ClearHistory() {
+    for (auto& byColor : history)
+        for (auto& byFrom : byColor)
+            for (int& entry : byFrom) entry = 0;
+    for (auto& byColor : counterMoves)
+        for (auto& byType : byColor)
+            for (Move& move : byType) move = Move::None();
+}
+
+void SearchWorker::SetForcedMove(const Position& root, Move move) {
+    position = root;
+    network = engine.network.get();
+    if (network) accumulators.Reset(position, *network);
+    previousPvLength = 0;
+    principalVariation.assign(1, move);
+    completedDepth = 0;
+    bestMove = move;
+    bestScore = EvaluateBoard();
+}
+
+void SearchWorker::Search(const Position& root, int maxDepth) {
+    position = root;
+    network = engine.network.get();
+    if (network) accumulators.Reset(position, *network);
+    previousPvLength = 0;
+    principalVariation.clear();
+    completedDepth = 0;
+    bestMove = Move::None();
+    bestScore = 0;
+
+    // Killers are tied to plies of this tree; history is only aged so the
+    // next search still profits from it
+    for (auto& slots : killers) slots[0] = slots[1] = Move::None();
+    for (auto& byColor : history)
+        for (auto& byFrom : byColor)
+            for (int& entry : byFrom) entry /= 2;
+
+    // Helpers start one ply deeper on every other thread so that they do
+    // not all search the same tree in lockstep
+    for (int depth = 1 + (id % 2); depth <= maxDepth; ++depth) {
+        // Aspiration window: the score rarely moves far between iterations,
+        // so search a narrow window around the last one and widen it only
+        // on the side where the score fell outside
+        int delta = 25;
+        int alpha = -INFINITE_SCORE;
+        int beta = INFINITE_SCORE;
+        if (depth >= 4 && std::abs(bestScore) < MATE_IN_MAX_PLY) {
+            alpha = std::max(bestScore - delta, -INFINITE_SCORE);
+            beta = std::min(bestScore + delta, INFINITE_SCORE);
+        }
+
+        int value;
+        Move move;
+        while (true) {
+            move = SearchRoot(depth, alpha, beta, value);
+            if (engine.IsTimeOut()) break;
+
+            if (value <= alpha) {
+                beta = (alpha + beta) / 2;
+                alpha = std::max(value - delta, -INFINITE_SCORE);
+            } else if (value >= beta) {
+                beta = std::min(value + delta, INFINITE_SCORE);
+            } else {
+                break;
+            }
+            delta *= 2;
+        }
+
+        // An unfinished iteration is thrown away, except that a partial
+        // first iteration still beats an unsearched move
+        if (engine.IsTimeOut()) {
+            if (completedDepth == 0 && !move.IsNone()) bestMove = move;
+            break;
+        }
+
+        bestMove = move;
+        bestScore = value;
+        completedDepth = depth;
+        previousPvLength = pvLength[0];
+        std::copy(pvTable[0], pvTable[0] + pvLength[0], previousPv);
+        principalVariation.assign(previousPv, previousPv + previousPvLength);
+
+        if (id == 0) engine.ReportIteration(*this);
+        engine.CheckTime();
+
+        // A forced mate will not change with more depth
+        if (std::abs(value) >= MATE_IN_MAX_PLY) break;
+    }
+}
@@ -0,0 +1,121 @@
+#ifndef SEARCHWORKER_H
+#define SEARCHWORKER_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "Move.h"
+#include "Evaluation.h"
+#include "MovePicker.h"
+#include "Nnue.h"
+#include "Position.h"
+
+class Engine;
+
+constexpr int MAX_SEARCH_DEPTH = 64;
+constexpr int MAX_PLY = 128;
+constexpr int HISTORY_MAX = 16384;
+
+// Scores are in centipawns from the side to move's point of view. Being
+// mated at ply n scores -(MATE_SCORE - n), so shorter mates score higher.
+constexpr int INFINITE_SCORE = 32000;
+constexpr int MATE_SCORE = 31000;
+constexpr int MATE_IN_MAX_PLY = MATE_SCORE - MAX_PLY;
+
+// Margins and depth limits of the pruning near the leaves; margins are in
+// centipawns per ply of remaining depth
+struct PruningParams {
+    // Reverse futility: cut when the static eval beats beta by the margin
+    int reverseFutilityDepth = 6;
+    int reverseFutilityMargin = 80;
+    // Razoring: drop into quiescence when the eval is far below alpha
+    int razoringDepth = 2;
+    int razoringMargin = 250;
+    // Futility: skip quiet moves that cannot lift the eval above alpha
+    int futilityDepth = 2;
+    int futilityMargin = 150;
+    // Late move pruning: skip quiet moves after base + depth^2 moves
+    int lateMovePruningDepth = 4;
+    int lateMovePruningBase = 3;
+};
+
+// Search and evaluation state of one search thread. All threads of a search
+// run their own iterative deepening from the same root on their own copy of
+// the position and share results only through the engine's transposition
+// table (Lazy SMP); thread 0's answer is the one played.
+class SearchWorker {
+public:
+    SearchWorker(Engine& engine, int id);
+
+    // Iterative deepening up to maxDepth or until the engine stops
+    void Search(const Position& root, int maxDepth);
+    // Result of a root with a single legal move, which is not searched:
+    // depth 0, the move as PV and the root's static evaluation as score
+    void SetForcedMove(const Position& root, Move move);
+
+    Move GetBestMove() const { return bestMove; }
+    int GetBestScore() const { return bestScore; }
+    // Principal variation and depth of the last completed iteration
+    const std::vector<Move>& GetPrincipalVariation() const { return principalVariation; }
+    int GetCompletedDepth() const { return completedDepth; }
+    // Safe to read from other threads while searching
+    uint64_t GetNodes() const { return nodes.load(std::memory_order_relaxed); }
+    // Evaluation cache lookups and how many of them hit
+    uint64_t GetEvalProbes() const { return evalProbes.load(std::memory_order_relaxed); }
+    uint64_t GetEvalHits() const { return evalHits.load(std::memory_order_relaxed); }
+    void ResetCounters() {
+        nodes = 0;
+        evalProbes = 0;
+        evalHits = 0;
+    }
+    // Forgets move ordering statistics, e.g. for a new game
+    void ClearHistory();
+
+private:
+    Move SearchRoot(int depth, int alpha, int beta, int& bestValue);
+    int Negamax(int depth, int ply, int alpha, int beta, bool nullAllowed = true);
+    int Quiescence(int ply, int alpha, int beta);
+    void CountNode();
+    void UpdatePv(int ply, Move move);
+    Move CounterMoveFor(int ply) const;
+    void UpdateQuietStats(Move move, int depth, int ply, const Move* quietsTried, int quietCount);
+    int Evaluate();
+    int EvaluateBoard();
+    void MakeMove(Move move, UndoInfo& undo);
+    void UnmakeMove(Move move, const UndoInfo& undo);
+    void MakeNullMove(UndoInfo& undo);
+    void UnmakeNullMove(const UndoInfo& undo);
+
+    Engine& engine;
+    int id;
+
+    Position position;
+    ClassicalEvaluator classical;
+    // The engine's network for this search, null for the classical eval
+    const Network* network = nullptr;
+    AccumulatorStack accumulators;
+
+    // Triangular PV table for the iteration in progress, and the previous
+    // iteration's PV, which the next one searches first
+    Move pvTable[MAX_PLY][MAX_PLY];
+    int pvLength[MAX_PLY];
+    Move previousPv[MAX_PLY];
+    int previousPvLength = 0;
+    bool followPv = false;
+
+    // Move ordering statistics, see MovePicker
+    Move moveStack[MAX_PLY];
+    Move killers[MAX_PLY][2];
+    Move counterMoves[3][7][64];
+    HistoryTable history;
+
+    std::vector<Move> principalVariation;
+    int completedDepth = 0;
+    Move bestMove = Move::None();
+    int bestScore = 0;
+    std::atomic<uint64_t> nodes{0};
+    std::atomic<uint64_t> evalProbes{0};
+    std::atomic<uint64_t> evalHits{0};
+};
+
+#endif // SEARCHWORKER_H
@@ -0,0 +1,62 @@
+#include "TranspositionTable.h"
+#include <climits>
+
+namespace {
+// Entry layout: move (16) | score (32) | depth (8) | bound (2) | generation (6)
+uint64_t Pack(Move move, int score, int depth, Bound bound, uint8_t generation) {
+    return uint64_t(move.Raw())
+         | (uint64_t(uint32_t(score)) << 16)
+         | (uint64_t(uint8_t(depth)) << 48)
+         | (uint64_t(bound) << 56)
+         | (uint64_t(generation) << 58);
+}
+
+Move MoveOf(uint64_t data) { return Move::FromRaw(uint16_t(data)); }
+int ScoreOf(uint64_t data) { return int32_t(uint32_t(data >> 16)); }
+int DepthOf(uint64_t data) { return int8_t(uint8_t(data >> 48)); }
+Bound BoundOf(uint64_t data) { return Bound((data >> 56) & 3); }
+uint8_t GenerationOf(uint64_t data) { return uint8_t(data >> 58); }
+}
+
+bool TranspositionTable::Probe(uint64_t key, TTEntry& entry) const {
+    for (const HashSlot& slot : table.BucketFor(key).slots) {
+        uint64_t data;
+        if (!slot.Probe(key, data)) continue;
+        if (BoundOf(data) == Bound::NONE) return false;
+
+        entry.move = MoveOf(data);
+        entry.score = ScoreOf(data);
+        entry.depth = DepthOf(data);
+        entry.bound = BoundOf(data);
+        return true;
+    }
+    return false;
+}
+
+void TranspositionTable::Store(uint64_t key, Move move, int score, int depth, Bound bound) {
+    // Reuse the entry for this position if there is one; otherwise evict
+    // the entry that is shallowest once its age is taken into account
+    HashSlot* target = nullptr;
+    int worst = INT_MAX;
+    for (HashSlot& slot : table.BucketFor(key).slots) {
+        uint64_t data = slot.Data();
+        if (slot.Holds(key, data)) {
+            // Keep a deeper result from this search unless the new one is exact
+            if (bound != Bound::EXACT && GenerationOf(data) == generation && depth + 2 < DepthOf(data)) {
+                return;
+            }
+            if (move.IsNone()) move = MoveOf(data);
+            target = &slot;
+            break;
+        }
+
+        int age = (generation - GenerationOf(data)) & 63;
+        int value = (BoundOf(data) == Bound::NONE) ? INT_MIN : DepthOf(data) - 8 * age;
+        if (value < worst) {
+            worst = value;
+            target = &slot;
+        }
+    }
+
+    target->Store(key, Pack(move, score, depth, bound, generation));
+}
@@ -0,0 +1,49 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include "HashTable.h"
+#include "Move.h"
+
+// How a stored score relates to the true value of the position.
+enum class Bound : uint8_t { NONE, UPPER, LOWER, EXACT };
+
+// Decoded contents of one table entry. Scores are from the point of view of
+// the side to move in the stored position.
+struct TTEntry {
+    Move move;
+    int score;
+    int depth;
+    Bound bound;
+};
+
+// Fixed-size hash table of search results shared by every search thread.
+// Entries are grouped four to a 64-byte bucket so a probe touches one cache
+// line.
+class TranspositionTable {
+public:
+    explicit TranspositionTable(size_t megabytes = 16) : table(megabytes) {}
+
+    // Reallocates (and empties) the table; the size is rounded down to a
+    // power-of-two number of buckets
+    void Resize(size_t megabytes) {
+        table.Resize(megabytes);
+        generation = 0;
+    }
+    void Clear() {
+        table.Clear();
+        generation = 0;
+    }
+    // Called once per search so entries from earlier searches age out first
+    void NewSearch() { generation = (generation + 1) & 63; }
+
+    bool Probe(uint64_t key, TTEntry& entry) const;
+    void Store(uint64_t key, Move move, int score, int depth, Bound bound);
+
+private:
+    LockFreeHashTable<4> table;
+    uint8_t generation = 0;
+};
+
+#endif // TRANSPOSITIONTABLE_H
@@ -0,0 +1,24 @@
+#ifndef TYPES_H
+#define TYPES_H
+
+enum class PieceType { NONE, PAWN, ROOK, KNIGHT, BISHOP, QUEEN, KING };
+enum class PieceColor { NONE, BLACK, WHITE };
+
+// Material values in centipawns, indexed by PieceType
+constexpr int PIECE_VALUES[7] = { 0, 100, 500, 320, 330, 900, 20000 };
+inline int PieceValue(PieceType type) { return PIECE_VALUES[int(type)]; }
+
+// Squares are numbered 0..63 from a1 to h8 (file-major within a rank).
+using Square = int;
+constexpr Square NO_SQUARE = -1;
+
+inline Square MakeSquare(int file, int rank) { return rank * 8 + file; }
+inline int FileOf(Square s) { return s & 7; }
+inline int RankOf(Square s) { return s >> 3; }
+inline bool IsInsideBoard(int file, int rank) { return file >= 0 && file < 8 && rank >= 0 && rank < 8; }
+
+inline PieceColor Opponent(PieceColor color) {
+    return (color == PieceColor::WHITE) ? PieceColor::BLACK : PieceColor::WHITE;
+}
+
+#endif // TYPES_H
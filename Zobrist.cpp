@@ -0,0 +1,40 @@
+#include "Zobrist.h"
+#include "Prng.h"
+#include <initializer_list>
+
+uint64_t ZobristPieces[3][7][64];
+uint64_t ZobristCastling[16];
+uint64_t ZobristEnPassant[8];
+uint64_t ZobristSide;
+
+namespace {
+void InitZobristKeys() {
+    Prng prng(1070372);
+
+    for (PieceColor color : { PieceColor::WHITE, PieceColor::BLACK }) {
+        for (int type = int(PieceType::PAWN); type <= int(PieceType::KING); ++type) {
+            for (Square s = 0; s < 64; ++s) {
+                ZobristPieces[int(color)][type][s] = prng.Next();
+            }
+        }
+    }
+
+    // One key per right; a combination is the XOR of its rights, so losing
+    // a single right changes the key the same way whatever else is held
+    uint64_t rightKeys[4];
+    for (uint64_t& k : rightKeys) k = prng.Next();
+    for (int rights = 0; rights < 16; ++rights) {
+        ZobristCastling[rights] = 0;
+        for (int i = 0; i < 4; ++i) {
+            if (rights & (1 << i)) ZobristCastling[rights] ^= rightKeys[i];
+        }
+    }
+
+    for (uint64_t& k : ZobristEnPassant) k = prng.Next();
+    ZobristSide = prng.Next();
+}
+
+struct ZobristInit {
+    ZobristInit() { InitZobristKeys(); }
+} zobristInit;
+}
@@ -0,0 +1,19 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+#include "Types.h"
+
+// Random keys XORed together into a 64-bit position key: one per piece on
+// each square, per castling-rights combination, per en passant file and for
+// black to move. Filled at startup (see Zobrist.cpp).
+extern uint64_t ZobristPieces[3][7][64];
+extern uint64_t ZobristCastling[16];
+extern uint64_t ZobristEnPassant[8];
+extern uint64_t ZobristSide;
+
+inline uint64_t PieceKey(PieceColor color, PieceType type, Square s) {
+    return ZobristPieces[int(color)][int(type)][s];
+}
+
+#endif // ZOBRIST_H
@@ -0,0 +1,138 @@
+// Evaluation benchmark. Walks the legal move tree of a few positions to a
+// fixed depth and evaluates every node, once with the classical evaluation
+// and once with the neural network for each available vector kernel set.
+//
+//   bench                      random network weights (speed only)
+//   bench --network FILE       weights from FILE
+//   options: --depth N
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "Evaluation.h"
+#include "MoveGen.h"
+#include "Nnue.h"
+#include "Position.h"
+
+namespace {
+const char* const kPositions[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+};
+
+struct ClassicalEval {
+    ClassicalEvaluator evaluator;
+    void Start(const Position&) {}
+    void Push(const Position&, Move) {}
+    void Pop() {}
+    int Evaluate(const Position& position) { return evaluator.Evaluate(position); }
+};
+
+// Every position from scratch, as without incremental updates
+struct NetworkRefresh {
+    const Network& network;
+    AccumulatorStack accumulators;
+    void Start(const Position&) {}
+    void Push(const Position&, Move) {}
+    void Pop() {}
+    int Evaluate(const Position& position) {
+        accumulators.Reset(position, network);
+        return accumulators.Evaluate(position, network);
+    }
+};
+
+struct NetworkIncremental {
+    const Network& network;
+    AccumulatorStack accumulators;
+    void Start(const Position& position) { accumulators.Reset(position, network); }
+    void Push(const Position& position, Move move) { accumulators.Push(position, move); }
+    void Pop() { accumulators.Pop(); }
+    int Evaluate(const Position& position) { return accumulators.Evaluate(position, network); }
+};
+
+template <typename Evaluator>
+void Walk(Position& position, int depth, Evaluator& evaluator, uint64_t& count, int64_t& checksum) {
+    checksum += evaluator.Evaluate(position);
+    ++count;
+    if (depth == 0) return;
+
+    MoveList moves;
+    GenerateLegalMoves(position, moves);
+    for (Move move : moves) {
+        UndoInfo undo;
+        evaluator.Push(position, move);
+        position.MakeMove(move, undo);
+        Walk(position, depth - 1, evaluator, count, checksum);
+        position.UnmakeMove(move, undo);
+        evaluator.Pop();
+    }
+}
+
+template <typename Evaluator>
+void Run(const char* name, Evaluator& evaluator, int depth) {
+    uint64_t count = 0;
+    int64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const char* fen : kPositions) {
+        Position position;
+        position.SetFromFen(fen);
+        evaluator.Start(position);
+        Walk(position, depth, evaluator, count, checksum);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-28s %10llu evals  %8.3f s  %8.2f Mevals/s  checksum %lld\n",
+                name, (unsigned long long)count, seconds, seconds > 0 ? count / seconds / 1e6 : 0.0,
+                (long long)checksum);
+}
+
+void PrintUsage() {
+    std::printf("usage: bench [--network FILE] [--depth N]\n"
+                "Without --network the network has random weights, which is only\n"
+                "meaningful for speed.\n");
+}
+}
+
+int main(int argc, char** argv) {
+    std::string networkPath;
+    int depth = 3;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--network" && hasValue) networkPath = argv[++i];
+        else if (arg == "--depth" && hasValue) depth = std::max(0, std::atoi(argv[++i]));
+        else {
+            PrintUsage();
+            return arg == "--help" ? 0 : 2;
+        }
+    }
+
+    Network network;
+    if (networkPath.empty()) {
+        network.InitRandom(1);
+    } else if (!network.Load(networkPath)) {
+        std::printf("cannot load network %s\n", networkPath.c_str());
+        return 1;
+    }
+
+    ClassicalEval classical;
+    Run("classical", classical, depth);
+
+    // Checksums of the network runs must agree: every kernel set computes
+    // the same integers
+    SimdLevel best = DetectSimdLevel();
+    for (int level = int(SimdLevel::SCALAR); level <= int(best); ++level) {
+        SetSimdLevel(SimdLevel(level));
+        std::string label = std::string("nnue ") + SimdLevelName(SimdLevel(level));
+
+        NetworkRefresh refresh{ network, {} };
+        Run((label + " refresh").c_str(), refresh, depth);
+        NetworkIncremental incremental{ network, {} };
+        Run((label + " incremental").c_str(), incremental, depth);
+    }
+    SetSimdLevel(best);
+    return 0;
+}
@@ -13,6 +13,8 @@ class BaseFrame : public wxFrame {
         Board* board;
         void OnReset(wxCommandEvent& event);
         void OnRandomColor(wxCommandEvent& event);
+        void OnUndo(wxCommandEvent& event);
+        void OnRedo(wxCommandEvent& event);
 };
 
 wxIMPLEMENT_APP(Chess);
@@ -33,12 +35,18 @@ BaseFrame::BaseFrame(const wxString& title) : wxFrame(NULL, wxID_ANY, title, wxD
     
     wxButton* resetButton = new wxButton(buttonPanel, wxID_ANY, "Reset Game");
     wxButton* randomColorButton = new wxButton(buttonPanel, wxID_ANY, "Random Color");
+    wxButton* undoButton = new wxButton(buttonPanel, wxID_ANY, "Undo");
+    wxButton* redoButton = new wxButton(buttonPanel, wxID_ANY, "Redo");
     
     resetButton->Bind(wxEVT_BUTTON, &BaseFrame::OnReset, this);
     randomColorButton->Bind(wxEVT_BUTTON, &BaseFrame::OnRandomColor, this);
+    undoButton->Bind(wxEVT_BUTTON, &BaseFrame::OnUndo, this);
+    redoButton->Bind(wxEVT_BUTTON, &BaseFrame::OnRedo, this);
     
     buttonSizer->Add(resetButton, 0, wxALL, 5);
     buttonSizer->Add(randomColorButton, 0, wxALL, 5);
+    buttonSizer->Add(undoButton, 0, wxALL, 5);
+    buttonSizer->Add(redoButton, 0, wxALL, 5);
     buttonPanel->SetSizer(buttonSizer);
     
     // Create chess board
@@ -48,6 +56,9 @@ BaseFrame::BaseFrame(const wxString& title) : wxFrame(NULL, wxID_ANY, title, wxD
     mainSizer->Add(buttonPanel, 0, wxALIGN_CENTER | wxTOP | wxBOTTOM, 10);
     mainSizer->Add(board, 1, wxEXPAND | wxALL, 5);
     mainPanel->SetSizer(mainSizer);
+
+    // Engine progress (depth, score, nodes, PV) is shown here while it thinks
+    CreateStatusBar();
     
     Centre();
 }
@@ -59,3 +70,11 @@ void BaseFrame::OnReset(wxCommandEvent& event) {
 void BaseFrame::OnRandomColor(wxCommandEvent& event) {
     board->SetRandomColor();
 }
+
+void BaseFrame::OnUndo(wxCommandEvent& event) {
+    board->UndoLastMove();
+}
+
+void BaseFrame::OnRedo(wxCommandEvent& event) {
+    board->RedoMove();
+}
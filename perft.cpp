@@ -0,0 +1,238 @@
+// Move generator benchmark and correctness check. Counts the leaf nodes of
+// the legal move tree to a fixed depth and compares them with published
+// reference values.
+//
+//   perft                     run the built-in suite
+//   perft --fen FEN --depth N count one position
+//   options: --divide  --threads N  --hash MB
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "HashTable.h"
+#include "MoveGen.h"
+#include "Position.h"
+
+namespace {
+struct PerftCase {
+    const char* name;
+    const char* fen;
+    int depth;
+    uint64_t nodes;
+};
+
+const PerftCase kSuite[] = {
+    { "start position", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 6, 119060324ULL },
+    { "kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 5, 193690690ULL },
+    { "rook endgame, en passant pins", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6, 11030083ULL },
+    { "promotions and castling rights", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5, 15833292ULL },
+    { "promotion into check", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 5, 89941194ULL },
+    { "symmetrical middlegame", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 5, 164075551ULL },
+    { "illegal en passant (rank pin)", "3k4/3p4/8/K1P4r/8/8/8/8 b - - 0 1", 6, 1134888ULL },
+    { "illegal en passant (diagonal pin)", "8/8/4k3/8/2p5/8/B2P2K1/8 w - - 0 1", 6, 1015133ULL },
+    { "en passant gives check", "8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1", 6, 1440467ULL },
+    { "short castling gives check", "5k2/8/8/8/8/8/8/4K2R w K - 0 1", 6, 661072ULL },
+    { "long castling gives check", "3k4/8/8/8/8/8/8/R3K3 w Q - 0 1", 6, 803711ULL },
+    { "castling rights", "r3k2r/1b4bq/8/8/8/8/7B/R3K2R w KQkq - 0 1", 4, 1274206ULL },
+    { "castling right without a rook", "4k3/8/8/8/8/8/8/4K3 w K - 0 1", 3, 170ULL },
+    { "castling prevented", "r3k2r/8/3Q4/8/8/5q2/8/R3K2R b KQkq - 0 1", 4, 1720476ULL },
+    { "promote out of check", "2K2r2/4P3/8/8/8/8/8/3k4 w - - 0 1", 6, 3821001ULL },
+    { "discovered check", "8/8/1P2K3/8/2n5/1q6/8/5k2 b - - 0 1", 5, 1004658ULL },
+    { "promote to give check", "4k3/1P6/8/8/8/8/K7/8 w - - 0 1", 6, 217342ULL },
+    { "underpromote to give check", "8/P1k5/K7/8/8/8/8/8 w - - 0 1", 6, 92683ULL },
+    { "self stalemate", "K1k5/8/P7/8/8/8/8/8 w - - 0 1", 6, 2217ULL },
+    { "stalemate and checkmate", "8/k1P5/8/1K6/8/8/8/8 w - - 0 1", 7, 567584ULL },
+    { "double check", "8/8/2k5/5q2/5n2/8/5K2/8 b - - 0 1", 4, 23527ULL },
+};
+
+// SetFromFen must refuse these rather than leave a position the generator
+// cannot handle
+const char* const kInvalidFens[] = {
+    "8/8/8/8/8/8/8/8 w - - 0 1",
+    "4k3/8/8/8/8/8/8/8 w - - 0 1",
+    "4k3/8/8/8/8/8/8/3KK3 w - - 0 1",
+    "4k3/8/8/8/8/8/8/4K3 x - - 0 1",
+    "4k3/8/8/8/8/8/8/4R1K1 w - - 0 1",
+};
+
+// Subtree counts keyed by position and depth, shared by all threads
+class PerftTable {
+public:
+    explicit PerftTable(size_t megabytes) : table(megabytes) {}
+
+    bool Probe(uint64_t key, int depth, uint64_t& nodes) const {
+        uint64_t data;
+        if (!table.BucketFor(key).slots[0].Probe(key, data) || int(data & 0xFF) != depth) return false;
+        nodes = data >> 8;
+        return true;
+    }
+
+    void Store(uint64_t key, int depth, uint64_t nodes) {
+        table.BucketFor(key).slots[0].Store(key, (nodes << 8) | uint64_t(depth));
+    }
+
+private:
+    LockFreeHashTable<1> table;
+};
+
+uint64_t Perft(Position& position, int depth, PerftTable* table) {
+    MoveList moves;
+    GenerateLegalMoves(position, moves);
+    // Bulk counting: the leaves are the legal moves of the last ply
+    if (depth <= 1) return depth == 1 ? moves.Size() : 1;
+
+    uint64_t key = 0;
+    uint64_t nodes = 0;
+    if (table) {
+        key = position.GetKey();
+        if (table->Probe(key, depth, nodes)) return nodes;
+    }
+
+    for (Move move : moves) {
+        UndoInfo undo;
+        position.MakeMove(move, undo);
+        nodes += Perft(position, depth - 1, table);
+        position.UnmakeMove(move, undo);
+    }
+
+    if (table) table->Store(key, depth, nodes);
+    return nodes;
+}
+
+// Counts every root move's subtree, handing root moves out to 'threads'
+// workers that each search their own copy of the position.
+std::vector<uint64_t> PerftDivide(const Position& root, const MoveList& moves, int depth,
+                                  int threads, PerftTable* table) {
+    std::vector<uint64_t> counts(moves.Size(), 0);
+    std::atomic<int> next{0};
+
+    auto worker = [&]() {
+        Position position = root;
+        for (int i = next++; i < moves.Size(); i = next++) {
+            UndoInfo undo;
+            position.MakeMove(moves[i], undo);
+            counts[i] = Perft(position, depth - 1, table);
+            position.UnmakeMove(moves[i], undo);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; ++i) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+    return counts;
+}
+
+bool RunCase(const char* name, const std::string& fen, int depth, uint64_t expected,
+             bool divide, int threads, size_t hashMegabytes) {
+    Position position;
+    if (!position.SetFromFen(fen)) {
+        std::printf("%-34s invalid FEN: %s\n", name, fen.c_str());
+        return false;
+    }
+
+    // A fresh table per case keeps timings independent of case order
+    std::unique_ptr<PerftTable> table;
+    if (hashMegabytes > 0) table.reset(new PerftTable(hashMegabytes));
+
+    MoveList moves;
+    GenerateLegalMoves(position, moves);
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t nodes = 0;
+    std::vector<uint64_t> counts;
+    if (depth <= 1) {
+        nodes = Perft(position, depth, nullptr);
+        // Each root move is a single leaf
+        if (depth == 1) counts.assign(moves.Size(), 1);
+    } else {
+        counts = PerftDivide(position, moves, depth, threads, table.get());
+        for (uint64_t c : counts) nodes += c;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (divide) {
+        for (int i = 0; i < int(counts.size()); ++i) {
+            std::printf("  %-6s %llu\n", moves[i].ToString().c_str(), (unsigned long long)counts[i]);
+        }
+    }
+
+    bool ok = (expected == 0 || nodes == expected);
+    double mnps = seconds > 0 ? nodes / seconds / 1e6 : 0.0;
+    std::printf("%-34s depth %d  nodes %12llu  %8.3f s  %8.2f Mnps  %s\n",
+                name, depth, (unsigned long long)nodes, seconds, mnps,
+                expected == 0 ? "" : (ok ? "OK" : "FAIL"));
+    if (!ok) {
+        std::printf("%-34s expected %llu\n", "", (unsigned long long)expected);
+    }
+    return ok;
+}
+
+void PrintUsage() {
+    std::printf("usage: perft [--fen FEN] [--depth N] [--divide] [--threads N] [--hash MB]\n"
+                "Without --fen, runs the built-in position suite; --depth then overrides\n"
+                "the per-position depth and disables the reference check.\n");
+}
+}
+
+int main(int argc, char** argv) {
+    std::string fen;
+    int depth = 0;
+    bool divide = false;
+    int threads = 1;
+    size_t hashMegabytes = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--fen" && hasValue) fen = argv[++i];
+        else if (arg == "--depth" && hasValue) depth = std::atoi(argv[++i]);
+        else if (arg == "--threads" && hasValue) threads = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--hash" && hasValue) hashMegabytes = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--divide") divide = true;
+        else {
+            PrintUsage();
+            return arg == "--help" ? 0 : 2;
+        }
+    }
+
+    if (!fen.empty()) {
+        return RunCase("position", fen, depth > 0 ? depth : 1, 0, divide, threads, hashMegabytes) ? 0 : 1;
+    }
+
+    int failures = 0;
+    uint64_t totalNodes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const PerftCase& c : kSuite) {
+        int caseDepth = depth > 0 ? depth : c.depth;
+        uint64_t expected = depth > 0 ? 0 : c.nodes;
+        if (!RunCase(c.name, c.fen, caseDepth, expected, divide, threads, hashMegabytes)) ++failures;
+        totalNodes += expected;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int accepted = 0;
+    for (const char* invalid : kInvalidFens) {
+        Position position;
+        if (position.SetFromFen(invalid)) {
+            std::printf("%-34s accepted: %s\n", "invalid FEN", invalid);
+            ++accepted;
+        }
+    }
+
+    if (depth > 0) {
+        std::printf("total %.3f s\n", seconds);
+        return accepted ? 1 : 0;
+    }
+    std::printf("%s: %d of %zu positions  total %.3f s  %.2f Mnps\n",
+                (failures || accepted) ? "FAILED" : "passed", int(std::size(kSuite)) - failures, std::size(kSuite),
+                seconds, seconds > 0 ? totalNodes / seconds / 1e6 : 0.0);
+    return (failures || accepted) ? 1 : 0;
+}